@@ -0,0 +1,31 @@
+#include "../x.hpp"
+
+using namespace x;
+
+// caller-side cost of one _log_info, percentiles over many calls
+int main() {
+    LogConfig cfg;
+    cfg.console   = false;
+    cfg.file      = "bench_log.log";
+    cfg.ring_size = 1 << 16;
+    Log::instance().start(cfg);
+
+    constexpr u32 kCalls = 200000;
+    _vec<u64> cost(kCalls);
+    str user = "bench-user";
+    for (u32 round = 0; round < 3; ++round) {
+        for (u32 i = 0; i < kCalls; ++i) {
+            auto t0 = std::chrono::steady_clock::now();
+            _log_info("request {} from {} took {:.3f} ms", i, user, i * 0.001);
+            auto t1 = std::chrono::steady_clock::now();
+            cost[i] = u64(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        }
+        Log::instance().flush();
+        std::sort(cost.begin(), cost.end());
+        _prtln("round {} : p50 {} ns  p99 {} ns  p99.9 {} ns  max {} ns  (dropped {})",
+               round, cost[kCalls / 2], cost[kCalls * 99 / 100], cost[kCalls * 999 / 1000],
+               cost.back(), Log::instance().dropped());
+    }
+    Log::instance().stop();
+    remove_file(cfg.file);
+}
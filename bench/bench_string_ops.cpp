@@ -0,0 +1,177 @@
+#include "../x.hpp"
+
+using namespace x;
+
+// run fn `loops` times, print avg us per loop
+template<typename F>
+static void bench(cStr& name, cU32& loops, F&& fn) {
+    u64 sink = 0;
+    auto begin = timestamp_us();
+    for (u32 i = 0; i < loops; ++i)
+        sink += fn();
+    auto cost = timestamp_us() - begin;
+    _prtln("{:<28} {:>10.2f} us/loop   (sink {})", name, f64(cost) / loops, sink);
+}
+
+static str make_lines(cU32& lines, cU32& fields) {
+    str s;
+    for (u32 i = 0; i < lines; ++i) {
+        for (u32 j = 0; j < fields; ++j) {
+            if (j) s += ',';
+            s += _fmt("field{}_{}", i, j);
+        }
+        s += '\n';
+    }
+    return s;
+}
+
+int main() {
+    cStr text = make_lines(10000, 16);
+    _prtln("input : {} bytes", text.size());
+
+    // -------- split / split_view / splitter --------
+    bench("split", 20, [&] {
+        u64 n = 0;
+        for (auto& line : split(text, "\n"))
+            n += split(line, ",").size();
+        return n;
+    });
+    bench("split_view", 20, [&] {
+        u64 n = 0;
+        for (auto line : split_view(text, "\n"))
+            n += split_view(line, ",").size();
+        return n;
+    });
+    bench("splitter", 20, [&] {
+        u64 n = 0;
+        for (auto line : splitter(text, "\n"))
+            for (auto field : splitter(line, ","))
+                n += field.size() != 0;
+        return n;
+    });
+
+    // -------- single byte search --------
+    bench("string::find(',')", 200, [&] {
+        u64 n = 0;
+        for (size_t p = text.find(','); p != str::npos; p = text.find(',', p + 1))
+            ++n;
+        return n;
+    });
+    bench("find_byte(',')", 200, [&] {
+        u64 n = 0;
+        for (size_t p = find_byte(text, ','); p != str::npos; p = find_byte(text, ',', p + 1))
+            ++n;
+        return n;
+    });
+    bench("string::find('\\n')", 200, [&] {
+        u64 n = 0;
+        for (size_t p = text.find('\n'); p != str::npos; p = text.find('\n', p + 1))
+            ++n;
+        return n;
+    });
+    bench("find_byte('\\n')", 200, [&] {
+        u64 n = 0;
+        for (size_t p = find_byte(text, '\n'); p != str::npos; p = find_byte(text, '\n', p + 1))
+            ++n;
+        return n;
+    });
+
+    // -------- replace chain / replace_many --------
+    _vec<std::pair<str, str>> rules;
+    for (u32 i = 0; i < 20; ++i)
+        rules.emplace_back(_fmt("field{}_", i * 7), _fmt("F{}:", i));
+    bench("replace x20", 5, [&] {
+        str s = text;
+        for (auto& [from, to] : rules)
+            s = replace(std::move(s), from, to);
+        return u64(s.size());
+    });
+    ReplaceSet rs;
+    for (auto& [from, to] : rules)
+        rs.add(from, to);
+    rs.build();
+    bench("replace_many x20", 5, [&] {
+        return u64(replace_many(text, rs).size());
+    });
+
+    // -------- case folding --------
+    bench("transform(::toupper)", 50, [&] {
+        str s = text;
+        std::transform(s.begin(), s.end(), s.begin(), ::toupper);
+        return u64(s[7]);
+    });
+    bench("upper_inplace", 50, [&] {
+        str s = text;
+        upper_inplace(s);
+        return u64(s[7]);
+    });
+    cStr text_upper = upper(text);
+    bench("same_nocase", 50, [&] {
+        return u64(same_nocase(text, text_upper));
+    });
+
+    // -------- repeated needle search --------
+    auto lines = split_view(text, "\n");
+    bench("contain(\"field9_15\")", 20, [&] {
+        u64 n = 0;
+        for (auto line : lines)
+            n += contain(line, "field9_15");
+        return n;
+    });
+    Pattern needle("field9_15");
+    bench("Pattern(\"field9_15\")", 20, [&] {
+        u64 n = 0;
+        for (auto line : lines)
+            n += needle.contains(line);
+        return n;
+    });
+
+    // -------- formatting --------
+    cStr row_fmt = "{:>8} | {:<12} | {:10.3f}";
+    bench("vfmt (runtime)", 200, [&] {
+        u64 n = 0;
+        for (u32 i = 0; i < 1000; ++i)
+            n += vfmt(row_fmt, i, "item", i * 0.5).size();
+        return n;
+    });
+    Format row(row_fmt);
+    bench("Format (cached parse)", 200, [&] {
+        u64 n = 0;
+        StrBuf<64> b;
+        for (u32 i = 0; i < 1000; ++i) {
+            b.clear();
+            n += row.format_to(b, i, "item", i * 0.5).size();
+        }
+        return n;
+    });
+    cStr plain_fmt = "{} | {} | {}";
+    bench("vfmt plain fields", 200, [&] {
+        u64 n = 0;
+        for (u32 i = 0; i < 1000; ++i)
+            n += vfmt(plain_fmt, i, "item", i * 0.5).size();
+        return n;
+    });
+    Format plain(plain_fmt);
+    bench("Format plain fields", 200, [&] {
+        u64 n = 0;
+        StrBuf<64> b;
+        for (u32 i = 0; i < 1000; ++i) {
+            b.clear();
+            n += plain.format_to(b, i, "item", i * 0.5).size();
+        }
+        return n;
+    });
+    bench("_fmt (checked)", 200, [&] {
+        u64 n = 0;
+        for (u32 i = 0; i < 1000; ++i)
+            n += _fmt("{:>8} | {:<12} | {:10.3f}", i, "item", i * 0.5).size();
+        return n;
+    });
+    bench("fmt_to (caller buffer)", 200, [&] {
+        u64 n = 0;
+        char buf[64];
+        for (u32 i = 0; i < 1000; ++i)
+            n += fmt_to(buf, "{:>8} | {:<12} | {:10.3f}", i, "item", i * 0.5).size();
+        return n;
+    });
+}
@@ -31,6 +31,93 @@ TEST_F(PrintTest, PrintFunction) {
     buffer.str("");
 }
 
+TEST_F(PrintTest, BufferedOutput) {
+    x::set_output({.mode = x::OutMode::Buffered, .flush_size = 1 << 20, .flush_ms = 0});
+    std::println("line {}", 1);
+    x::vprtln("line {}", 2);
+    std::print("no newline");
+    EXPECT_EQ(buffer.str(), "");            // nothing written yet
+    x::flush_output();
+    EXPECT_EQ(buffer.str(), "line 1\nline 2\nno newline");
+    buffer.str("");
+
+    // size policy
+    x::set_output({.mode = x::OutMode::Buffered, .flush_size = 16, .flush_ms = 0});
+    std::println("0123456789");
+    EXPECT_EQ(buffer.str(), "");
+    std::println("abcdef");
+    EXPECT_EQ(buffer.str(), "0123456789\nabcdef\n");
+    buffer.str("");
+
+    // other threads' buffers, flushed at thread exit
+    std::thread([] { std::println("from thread"); }).join();
+    EXPECT_EQ(buffer.str(), "from thread\n");
+    buffer.str("");
+
+    // switching back flushes what is pending
+    std::print("pending");
+    x::set_output({});
+    EXPECT_EQ(buffer.str(), "pending");
+    EXPECT_EQ(x::output_policy().mode, x::OutMode::Stream);
+}
+
+TEST_F(PrintTest, DirectFdStream) {
+    // straight to fd 1, std::cout is bypassed
+    x::set_output({.direct_fd = true});
+    ::testing::internal::CaptureStdout();
+    std::println("direct {}", 1);
+    std::print("tail");
+    str out = ::testing::internal::GetCapturedStdout();
+    x::set_output({});
+    EXPECT_EQ(out, "direct 1\ntail");
+    EXPECT_EQ(buffer.str(), "");
+}
+
+// stringbuf the background flusher can write to while the test reads it
+class LockedBuf : public std::stringbuf {
+public:
+    std::string text() {
+        std::lock_guard<std::recursive_mutex> lock(m_);
+        return str();
+    }
+
+protected:
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        std::lock_guard<std::recursive_mutex> lock(m_);
+        return std::stringbuf::xsputn(s, n);
+    }
+
+    int_type overflow(int_type c) override {
+        std::lock_guard<std::recursive_mutex> lock(m_);
+        return std::stringbuf::overflow(c);
+    }
+
+    int sync() override {
+        std::lock_guard<std::recursive_mutex> lock(m_);
+        return std::stringbuf::sync();
+    }
+
+private:
+    std::recursive_mutex m_;   // xsputn may call overflow
+};
+
+TEST(PrintTimeFlushTest, IdleLineFlushedByTime) {
+    LockedBuf buf;
+    auto* old = std::cout.rdbuf(&buf);
+    x::set_output({.mode = x::OutMode::Buffered, .flush_size = 1 << 20, .flush_ms = 20});
+    std::println("idle line");
+    EXPECT_EQ(buf.text(), "");
+
+    // no further write : the flusher has to get it out
+    auto until = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (buf.text().empty() && std::chrono::steady_clock::now() < until)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_EQ(buf.text(), "idle line\n");
+
+    x::set_output({});
+    std::cout.rdbuf(old);
+}
+
 TEST(XTest, BasicTest) {
     _vec<u32> v = {1, 2, 3};
     EXPECT_EQ(v.size(), 3);
@@ -69,6 +156,51 @@ TEST(XTest,Print){
     EXPECT_EQ(vfmt("literal string"), "literal string");
 }
 
+TEST(XTest, FmtTo) {
+    char buf[16];
+    EXPECT_EQ(fmt_to(buf, "id={} t={:.1f}", 7, 2.5), "id=7 t=2.5");
+    // truncates to the buffer
+    EXPECT_EQ(fmt_to(buf, "{}", str(40, 'z')), str(16, 'z'));
+    EXPECT_EQ(fmt_size("{}-{}", 12, "ab"), 5);
+
+    StrBuf<8> sb;
+    fmt_to(sb, "{}", 1);
+    fmt_to(sb, ",{:>10}", "right");
+    EXPECT_EQ(sb.view(), "1,     right");
+
+    str s = "x=";
+    fmt_to(s, "{:04}", 42);
+    EXPECT_EQ(s, "x=0042");
+
+    auto b = fmt_buf("{}:{}", "host", 80);
+    EXPECT_EQ(b.view(), "host:80");
+    EXPECT_FALSE(b.on_heap());
+}
+
+TEST(XTest, FormatCached) {
+    Format f("{{{}}} {:>5}|{:.2f} }}");
+    EXPECT_EQ(f.fields(), 3);
+    EXPECT_EQ(f.format("a", 42, 3.14159), "{a}    42|3.14 }");
+    EXPECT_EQ(f.format("b", 1, 0.5), "{b}     1|0.50 }");
+
+    Format pos("{1} {0} {1}");
+    EXPECT_EQ(pos.format("world", "hello"), "hello world hello");
+
+    // nested width falls back to a full vformat
+    Format nested("[{:{}}]");
+    EXPECT_EQ(nested.format("ab", 4), "[ab  ]");
+
+    StrBuf<16> sb;
+    Format("{}+{}").format_to(sb, 1, 2);
+    EXPECT_EQ(sb.view(), "1+2");
+
+    EXPECT_EQ(Format("plain").format(), "plain");
+    EXPECT_THROW(Format("{"), std::format_error);
+    EXPECT_THROW(Format("}"), std::format_error);
+    EXPECT_THROW(Format("{} {0}"), std::format_error);
+    EXPECT_THROW(Format("{} {}").format(1), std::format_error);
+}
+
 TEST(XTest, PrintEdgeCases) {
     // Test printing empty string
     testing::internal::CaptureStdout();
@@ -95,6 +227,12 @@ TEST(XTest, CompileTimeConcat) {
 TEST(XTest, MacroTest) {
     EXPECT_EQ(_code_info(),_fmt("test_basic.cpp/{}/{}", __LINE__,__func__));
     EXPECT_EQ(_excode_info("123"), _fmt("test_basic.cpp/{}/123", __LINE__));
+    static_assert(_file_name() == "test_basic.cpp");
+    static_assert(_excode_info("tag").ends_with("/tag"));
+    static_assert(_excode_id("a") != _excode_id("b"));
+    // same location -> same static storage
+    auto at = [] { return _code_info(); };
+    EXPECT_EQ(at().data(), at().data());
     str build_time = _build_time();
     EXPECT_FALSE(build_time.empty());
     _prt("Code info: {}\n", _code_info());
@@ -0,0 +1,104 @@
+#include "../x.hpp"
+#include <gtest/gtest.h>
+
+using namespace x;
+
+namespace {
+_vec<_vec<str>> read_all(CsvReader& csv) {
+    _vec<_vec<str>> rows;
+    while (csv.next())
+        rows.emplace_back(csv.row().begin(), csv.row().end());
+    return rows;
+}
+}
+
+TEST(CsvTest, PlainRows) {
+    auto csv = CsvReader::from_buffer("a,b,c\n1,2,3\r\n\n4,,6,\n7");
+    auto rows = read_all(csv);
+    ASSERT_EQ(rows.size(), 4);
+    EXPECT_EQ(rows[0], (_vec<str>{"a", "b", "c"}));
+    EXPECT_EQ(rows[1], (_vec<str>{"1", "2", "3"}));    // \r\n
+    EXPECT_EQ(rows[2], (_vec<str>{"4", "", "6", ""}));  // empty fields, empty line skipped
+    EXPECT_EQ(rows[3], (_vec<str>{"7"}));               // last line without newline
+    EXPECT_FALSE(csv.next());
+}
+
+TEST(CsvTest, QuotedFields) {
+    auto csv = CsvReader::from_buffer(
+        "id,text\n"
+        "1,\"hello, world\"\n"
+        "2,\"say \"\"hi\"\"\"\n"
+        "3,\"multi\nline\"\n"
+        "4,\"\"\n");
+    auto rows = read_all(csv);
+    ASSERT_EQ(rows.size(), 5);
+    EXPECT_EQ(rows[1], (_vec<str>{"1", "hello, world"}));
+    EXPECT_EQ(rows[2], (_vec<str>{"2", "say \"hi\""}));
+    EXPECT_EQ(rows[3], (_vec<str>{"3", "multi\nline"}));
+    EXPECT_EQ(rows[4], (_vec<str>{"4", ""}));
+}
+
+TEST(CsvTest, HeaderAndTypedColumns) {
+    CsvReader::Options opt;
+    opt.delimiter  = '\t';
+    opt.has_header = true;
+    auto tsv = CsvReader::from_buffer("name\tage\tscore\nann\t30\t1.5\nbob\tx\t2\n", opt);
+    EXPECT_EQ(tsv.header(), (_vec<str>{"name", "age", "score"}));
+    EXPECT_EQ(tsv.index("score"), 2);
+    EXPECT_EQ(tsv.index("nope"), sView::npos);
+
+    ASSERT_TRUE(tsv.next());
+    EXPECT_EQ(tsv[0], "ann");
+    EXPECT_EQ(tsv.get<i32>("age"), 30);
+    EXPECT_DOUBLE_EQ(*tsv.get<f64>(2), 1.5);
+    ASSERT_TRUE(tsv.next());
+    EXPECT_FALSE(tsv.get<i32>(1));
+    EXPECT_FALSE(tsv.get<i32>(9));
+    EXPECT_EQ(tsv[9], "");
+    EXPECT_FALSE(tsv.next());
+}
+
+TEST(CsvTest, SmallChunksFromFile) {
+    // rows and quoted fields straddle chunk boundaries, one row is larger than a chunk
+    str path = "test_csv_temp.csv";
+    str content;
+    _vec<_vec<str>> expect;
+    for (i32 i = 0; i < 500; ++i) {
+        str text = i % 7 == 0 ? str(150, 'x') : _fmt("t{}", i);
+        bool quote = i % 3 == 0;
+        content += _fmt("{},{}{}{},{}\n", i, quote ? "\"" : "", quote ? text + ",\"\"q\"\"" : text,
+                        quote ? "\"" : "", i * 2);
+        expect.push_back({_fmt("{}", i), quote ? text + ",\"q\"" : text, _fmt("{}", i * 2)});
+    }
+    write_file(path, content);
+
+    CsvReader::Options opt;
+    opt.chunk_size = 64;
+    CsvReader csv(path, opt);
+    ASSERT_TRUE(csv.is_open());
+    i64 sum = 0;
+    size_t n = 0;
+    for (auto row : csv) {
+        ASSERT_EQ(row.size(), 3);
+        EXPECT_EQ(str(row[1]), expect[n][1]);
+        sum += parse<i64>(row[2]).value_or(0);
+        ++n;
+    }
+    EXPECT_EQ(n, 500);
+    EXPECT_EQ(sum, 499 * 500);
+    remove_file(path);
+
+    CsvReader missing("no_such_file.csv");
+    EXPECT_FALSE(missing.is_open());
+    EXPECT_FALSE(missing.next());
+
+    // literal path with options
+    write_file("test_csv_temp.tsv", "a\tb\n");
+    {
+        CsvReader tsv("test_csv_temp.tsv", {.delimiter = '\t'});
+        ASSERT_TRUE(tsv.next());
+        EXPECT_EQ(tsv.size(), 2);
+        EXPECT_EQ(tsv[1], "b");
+    }
+    remove_file("test_csv_temp.tsv");
+}
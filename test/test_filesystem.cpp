@@ -42,7 +42,453 @@ TEST_F(FilesystemTest, TestReadWriteFile) {
 
     x::write_file(test_file, "new content");
     EXPECT_EQ(x::read_file(test_file), "new content");
+
+    x::StrBuf buf;
+    buf.append("from ").append_fmt("{}", "StrBuf");
+    x::write_file(test_file, buf);
+    EXPECT_EQ(x::read_file(test_file), "from StrBuf");
+}
+
+TEST_F(FilesystemTest, TestWriteFileModes) {
+    x::write_file(test_file, "a\r\n");
+    x::write_file(test_file, "b\n", {.append = true});
+    EXPECT_EQ(x::read_file(test_file), "a\r\nb\n");
+
+    // many buffers, more than one writev batch
+    _vec<str>   rows;
+    _vec<sView> parts;
+    str         expect;
+    for (u32 i = 0; i < 3000; ++i) rows.push_back(_fmt("{},", i));
+    for (auto& r : rows) { parts.push_back(r); parts.push_back(""); expect += r; }
+    x::write_file(test_file, parts, {.atomic = true, .sync = true});
+    EXPECT_EQ(x::read_file(test_file), expect);
+
+    x::write_file(test_file, {"head|", "body|", "tail"}, {.sync = true});
+    EXPECT_EQ(x::read_file(test_file), "head|body|tail");
+
+    // atomic replace leaves no temp file behind
+    x::write_file(test_file, "replaced", {.atomic = true});
+    EXPECT_EQ(x::read_file(test_file), "replaced");
+    EXPECT_EQ(x::list_dir(test_dir).size(), 1);
+
+    EXPECT_THROW(x::write_file(test_file, "x", {.append = true, .atomic = true}), std::runtime_error);
+    EXPECT_THROW(x::write_file(test_dir + "/missing/f.txt", "x"), std::runtime_error);
+    EXPECT_THROW(x::write_file(test_dir + "/missing/f.txt", "x", {.atomic = true}), std::runtime_error);
+}
+
+TEST_F(FilesystemTest, TestMappedFile) {
+    str big;
+    for (u32 i = 0; i < 20000; ++i) big += _fmt("line {}\r\n", i);
+    x::write_file(test_file, big);
+    // binary : \r\n kept as is
+    EXPECT_EQ(x::read_file(test_file), big);
+
+    x::MappedFile m(test_file, {.advice = x::MapAdvice::Sequential, .huge_pages = true});
+    ASSERT_TRUE(m.is_open());
+    EXPECT_EQ(m.size(), big.size());
+    EXPECT_EQ(m.view(), big);
+    EXPECT_EQ(m.bytes().size(), big.size());
+    EXPECT_EQ(m.bytes()[0], u8('l'));
+    EXPECT_TRUE(x::contain(m, "line 19999\r\n"));
+    EXPECT_TRUE(m.advise(x::MapAdvice::Random, 5000, 100));
+    EXPECT_FALSE(m.advise(x::MapAdvice::Random, big.size()));
+
+    x::MappedFile moved = std::move(m);
+    EXPECT_FALSE(m.is_open());
+    EXPECT_TRUE(x::endWith(moved.view(), "line 19999\r\n"));
+    moved.close();
+    EXPECT_TRUE(moved.view().empty());
+
+    x::write_file(test_file, "");
+    x::MappedFile empty(test_file);
+    EXPECT_TRUE(empty.is_open());
+    EXPECT_TRUE(empty.empty());
+
+    EXPECT_FALSE(x::MappedFile("nonexistent").is_open());
+    EXPECT_FALSE(x::MappedFile(test_dir).is_open());
+}
+
+TEST_F(FilesystemTest, TestReadLines) {
+    _vec<str> expect;
+    str       content;
+    for (u32 i = 0; i < 5000; ++i) {
+        expect.push_back(i % 7 == 0 ? str() : _fmt("line {} {}", i, str(i % 50, 'x')));
+        content += expect.back();
+        content += i % 2 ? "\r\n" : "\n";
+    }
+    // longer than the slack kept for a line crossing chunks
+    expect.push_back(str(200000, 'L'));
+    content += expect.back() + "\n";
+    expect.push_back("last line without newline");
+    content += expect.back();
+    x::write_file(test_file, content);
+
+    for (size_t chunk : {size_t(1), size_t(8192), size_t(1) << 20}) {
+        _vec<str> got;
+        for (sView line : x::read_lines(test_file, chunk))
+            got.emplace_back(line);
+        EXPECT_EQ(got, expect) << "chunk " << chunk;
+    }
+
+    x::LineReader r(test_file);
+    size_t n = 0;
+    while (r.next()) ++n;
+    EXPECT_EQ(n, expect.size());
+    EXPECT_EQ(r.lines(), expect.size());
+    EXPECT_FALSE(r.next());
+
+    x::write_file(test_file, "a\n\nb\n");
+    x::LineReader moved = x::read_lines(test_file);
+    ASSERT_TRUE(moved.next());
+    EXPECT_EQ(moved.line(), "a");
+    x::LineReader other = std::move(moved);
+    EXPECT_FALSE(moved.is_open());
+    EXPECT_FALSE(moved.next());
+    ASSERT_TRUE(other.next());
+    EXPECT_EQ(other.line(), "");
+    ASSERT_TRUE(other.next());
+    EXPECT_EQ(other.line(), "b");
+    EXPECT_FALSE(other.next());
+    moved = std::move(other);
+    EXPECT_FALSE(other.next());
+    EXPECT_FALSE(moved.next());
+
+    x::write_file(test_file, "");
+    EXPECT_FALSE(x::read_lines(test_file).next());
+    x::LineReader missing("nonexistent");
+    EXPECT_FALSE(missing.is_open());
+    EXPECT_FALSE(missing.next());
+}
+
+TEST_F(FilesystemTest, TestWalk) {
+    // test_dir/{test.txt, a/{x.cpp, x.h, .hidden.cpp, b/{y.cpp, c/z.cpp}}}
+    x::create_dir(test_dir + "/a");
+    x::create_dir(test_dir + "/a/b");
+    x::create_dir(test_dir + "/a/b/c");
+    x::write_file(test_dir + "/a/x.cpp", "12345");
+    x::write_file(test_dir + "/a/x.h", "1");
+    x::write_file(test_dir + "/a/.hidden.cpp", "");
+    x::write_file(test_dir + "/a/b/y.cpp", "");
+    x::write_file(test_dir + "/a/b/c/z.cpp", "");
+
+    auto names = [](const _vec<x::WalkEntry>& es) {
+        _vec<str> r;
+        for (auto& e : es) r.emplace_back(e.name());
+        std::sort(r.begin(), r.end());
+        return r;
+    };
+
+    auto all = x::walk(test_dir, {.threads = 4});
+    EXPECT_EQ(all.size(), 9);
+    for (auto& e : all) {
+        EXPECT_EQ(e.type == x::FileType::Dir, x::is_dir(e.path)) << e.path;
+        if (e.type == x::FileType::File) {
+            EXPECT_EQ(e.size, x::file_size(e.path)) << e.path;
+        }
+        EXPECT_LT(std::chrono::system_clock::now() - e.mtime, std::chrono::hours(1));
+        if (e.name() == "z.cpp") {
+            EXPECT_EQ(e.depth, 4);
+        }
+    }
+
+    EXPECT_EQ(names(x::walk(test_dir, {.extensions = {"cpp"}, .include_dirs = false})),
+              (_vec<str>{".hidden.cpp", "x.cpp", "y.cpp", "z.cpp"}));
+    EXPECT_EQ(names(x::walk(test_dir, {.extensions = {"cpp", "h"}, .include_dirs = false, .skip_hidden = true})),
+              (_vec<str>{"x.cpp", "x.h", "y.cpp", "z.cpp"}));
+    EXPECT_EQ(names(x::walk(test_dir, {.max_depth = 2})),
+              (_vec<str>{".hidden.cpp", "a", "b", "test.txt", "x.cpp", "x.h"}));
+    EXPECT_EQ(names(x::walk(test_dir, {.glob = "[xz].*", .include_dirs = false})),
+              (_vec<str>{"x.cpp", "x.h", "z.cpp"}));
+
+    auto quick = x::walk(test_dir, {.stat = false});
+    EXPECT_EQ(quick.size(), 9);
+    EXPECT_TRUE(std::all_of(quick.begin(), quick.end(), [](auto& e) { return e.size == 0; }));
+
+    // early stop
+    EXPECT_EQ(x::walk(test_dir, {.max_entries = 3, .threads = 2}).size(), 3);
+    size_t seen = 0;
+    auto stopped = x::walk(test_dir, {.on_entry = [&](const x::WalkEntry&) { return ++seen < 2; }});
+    EXPECT_EQ(stopped.size(), 2);
+
+    EXPECT_TRUE(x::walk("nonexistent").empty());
+    EXPECT_TRUE(x::walk(test_file).empty());
+
+    EXPECT_TRUE(x::detail::glob_match("*.c*", "main.cpp"));
+    EXPECT_TRUE(x::detail::glob_match("a?c", "abc"));
+    EXPECT_TRUE(x::detail::glob_match("[!a-c]*", "data"));
+    EXPECT_FALSE(x::detail::glob_match("[!a-c]*", "beta"));
+    EXPECT_TRUE(x::detail::glob_match("[]x]", "]"));
+    EXPECT_TRUE(x::detail::glob_match("a[b", "a[b"));
+    EXPECT_FALSE(x::detail::glob_match("*.h", "x.hpp"));
+    EXPECT_TRUE(x::detail::glob_match("**", ""));
+}
+
+#ifndef _WIN32
+TEST_F(FilesystemTest, TestWalkFollowLinks) {
+    // test_dir/{test.txt, a/{x.cpp, b/y.cpp, up -> ..}, link -> a}
+    x::create_dir(test_dir + "/a");
+    x::create_dir(test_dir + "/a/b");
+    x::write_file(test_dir + "/a/x.cpp", "");
+    x::write_file(test_dir + "/a/b/y.cpp", "");
+    fs::create_directory_symlink("..", test_dir + "/a/up");
+    fs::create_directory_symlink("a", test_dir + "/link");
+
+    // a and link are the same directory and up loops back to the root :
+    // each is listed, but descended only once
+    for (bool stat : {false, true}) {
+        _vec<str> names;
+        for (auto& e : x::walk(test_dir, {.follow_links = true, .stat = stat, .threads = 2}))
+            names.emplace_back(e.name());
+        std::sort(names.begin(), names.end());
+        EXPECT_EQ(names, (_vec<str>{"a", "b", "link", "test.txt", "up", "x.cpp", "y.cpp"})) << stat;
+    }
+}
+#endif
+
+TEST_F(FilesystemTest, TestStat) {
+    x::Stat f = x::stat(test_file);
+    EXPECT_TRUE(f.exists());
+    EXPECT_TRUE(f.is_file());
+    EXPECT_EQ(f.size, 12);
+    EXPECT_NE(f.mode, 0);
+    EXPECT_LT(std::chrono::system_clock::now() - f.mtime, std::chrono::hours(1));
+
+    x::Stat d = x::stat(test_dir);
+    EXPECT_TRUE(d.is_dir());
+    EXPECT_EQ(d.size, 0);
+    EXPECT_EQ(x::file_size(test_dir), 0);
+
+    EXPECT_FALSE(x::stat("nonexistent").exists());
+    EXPECT_EQ(x::stat("nonexistent").type, x::FileType::None);
+
+#ifndef _WIN32
+    fs::create_symlink("test.txt", test_dir + "/link");
+    EXPECT_TRUE(x::stat(test_dir + "/link").is_file());
+    EXPECT_EQ(x::stat(test_dir + "/link", false).type, x::FileType::Symlink);
+#endif
+}
+
+TEST_F(FilesystemTest, TestStatCache) {
+    x::StatCache cache(std::chrono::hours(1), 2);
+    EXPECT_EQ(cache.file_size(test_file), 12);
+    x::write_file(test_file, "longer content");
+    // still the cached size until invalidated
+    EXPECT_EQ(cache.file_size(test_file), 12);
+    EXPECT_EQ(cache.hits(), 1);
+    cache.invalidate(test_file);
+    EXPECT_EQ(cache.file_size(test_file), 14);
+
+    EXPECT_FALSE(cache.exists("nonexistent"));
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_TRUE(cache.get(test_dir).is_dir());   // over capacity : evicted
+    EXPECT_LE(cache.size(), 2);
+
+    // just over capacity : the oldest go, recent entries stay cached
+    x::StatCache ring(std::chrono::hours(1), 64);
+    for (int i = 0; i <= 64; ++i) ring.exists(_fmt("{}/missing{}", test_dir, i));
+    EXPECT_GE(ring.size(), 56u);
+    EXPECT_LE(ring.size(), 64u);
+    ring.exists(_fmt("{}/missing63", test_dir));
+    ring.exists(_fmt("{}/missing64", test_dir));
+    EXPECT_EQ(ring.hits(), 2);
+
+    x::StatCache fresh(std::chrono::seconds(0));
+    EXPECT_EQ(fresh.file_size(test_file), 14);
+    x::write_file(test_file, "x");
+    EXPECT_EQ(fresh.file_size(test_file), 1);
+    EXPECT_EQ(fresh.hits(), 0);
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0);
+}
+
+TEST_F(FilesystemTest, TestReadFiles) {
+    _vec<str> paths, expect;
+    for (u32 i = 0; i < 300; ++i) {
+        paths.push_back(_fmt("{}/f{}.txt", test_dir, i));
+        expect.push_back(str(i * 7 % 1000, char('a' + i % 26)));
+        x::write_file(paths.back(), expect.back());
+    }
+    paths.push_back(test_dir + "/missing.txt");
+    paths.push_back(test_dir);
+
+    auto batch = x::read_files(paths, 4);
+    ASSERT_EQ(batch.size(), paths.size());
+    u64 total = 0;
+    for (size_t i = 0; i < expect.size(); ++i) {
+        EXPECT_TRUE(batch[i].ok());
+        EXPECT_EQ(batch[i].data, expect[i]);
+        total += expect[i].size();
+    }
+    EXPECT_EQ(batch.bytes(), total);
+    EXPECT_EQ(batch[300].error, ENOENT);
+    EXPECT_EQ(batch[301].error, EISDIR);
+    EXPECT_TRUE(batch[300].data.empty());
+
+    // views outlive a move of the batch
+    sView first = batch[1].data;
+    x::FileBatch moved = std::move(batch);
+    EXPECT_EQ(first, expect[1]);
+    EXPECT_EQ(moved[1].data.data(), first.data());
+
+#if defined(X_URING) && defined(X_TEST_HOOKS)
+    // io_uring_enter failing in the stat pass or mid-read : the pool redoes the batch
+    for (i32 after : {0, 1, 2, 4, 6}) {
+        x::detail::uring_fault = {.after = after};
+        auto again = x::read_files(paths);
+        x::detail::uring_fault = {};
+        ASSERT_EQ(again.size(), paths.size());
+        for (size_t i = 0; i < expect.size(); ++i)
+            EXPECT_EQ(again[i].data, expect[i]) << "after " << after;
+        EXPECT_EQ(again.bytes(), total);
+        EXPECT_EQ(again[300].error, ENOENT);
+        EXPECT_EQ(again[301].error, EISDIR);
+    }
+#endif
+
+    EXPECT_TRUE(x::read_files({}).empty());
+}
+
+TEST_F(FilesystemTest, TestHashFile) {
+    str data;
+    for (u32 i = 0; i < 20000; ++i) data += "line " + std::to_string(i) + "\n";
+    str path = test_dir + "/hash.bin";
+    x::write_file(path, data);
+
+    EXPECT_EQ(x::hash_file(path), x::hash_bytes(data));
+    EXPECT_EQ(x::hash_file(path, {.seed = 3}), x::hash_bytes(data, 3));
+    EXPECT_EQ(x::hash_file128(path), x::hash_bytes128(data));
+    EXPECT_EQ(x::hash_file(path, {.chunk = 4096}), x::hash_tree(data, {.chunk = 4096}));
+    EXPECT_EQ(x::hash_file128(path, {.chunk = 4096, .threads = 3}), x::hash_tree128(data, {.chunk = 4096}));
+    EXPECT_EQ(x::crc32c_file(path), x::crc32c(data));
+
+    x::write_file(path, "");
+    EXPECT_EQ(x::hash_file(path), x::hash_bytes(""));
+    EXPECT_FALSE(x::hash_file("nonexistent").has_value());
+    EXPECT_FALSE(x::hash_file(test_dir).has_value());
+#ifdef __linux__
+    // reports no size up front : streamed
+    EXPECT_EQ(x::hash_file("/proc/version"), x::hash_bytes(x::read_file("/proc/version")));
+
+    // streamed through a fifo : same tree hash as the mapped file
+    str fifo = test_dir + "/hash.fifo";
+    ASSERT_EQ(::mkfifo(fifo.c_str(), 0600), 0);
+    auto streamed = [&](cStr& bytes, auto&& hash) {
+        std::thread w([&] {
+            std::ofstream out(fifo, std::ios::binary);
+            for (size_t off = 0; off < bytes.size(); off += 1000)
+                out.write(bytes.data() + off, std::streamsize(std::min<size_t>(1000, bytes.size() - off)));
+        });
+        auto r = hash(fifo);
+        w.join();
+        return r;
+    };
+    for (size_t n : {size_t(100), size_t(4096), size_t(3 * 4096), data.size()}) {
+        str part = data.substr(0, n);
+        x::write_file(path, part);
+        x::HashOptions opt{.seed = 5, .chunk = 4096};
+        EXPECT_EQ(streamed(part, [&](cStr& p) { return x::hash_file(p, opt); }), x::hash_file(path, opt)) << n;
+        EXPECT_EQ(streamed(part, [&](cStr& p) { return x::hash_file128(p, opt); }), x::hash_file128(path, opt)) << n;
+        EXPECT_EQ(x::hash_file(path, opt), x::hash_tree(part, opt)) << n;
+    }
+#endif
+}
+
+TEST_F(FilesystemTest, TestFileWatcher) {
+    for (bool poll : {false, true}) {
+        str sub = test_dir + "/watched";
+        x::create_dir(sub);
+        x::write_file(sub + "/old.txt", "1");
+
+        std::mutex               m;
+        std::map<str, WatchEvent> seen;
+        u32                      batches = 0;
+        x::FileWatcher w;
+        EXPECT_TRUE(w.add(test_file));
+        EXPECT_TRUE(w.add(sub + "/"));
+        EXPECT_FALSE(w.add("nonexistent"));
+        w.start([&](const _vec<x::FileEvent>& evs) {
+            std::lock_guard lk(m);
+            ++batches;
+            for (auto& e : evs) seen[e.path] = e.kind;
+        }, {.debounce_ms = 30, .poll_ms = 20, .force_poll = poll});
+#ifdef __linux__
+        EXPECT_EQ(w.polling(), poll);
+#endif
+        // mtime granularity for the polling diff
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        x::write_file(test_file, "changed");
+        x::write_file(test_file, "changed again");
+        x::write_file(sub + "/new.txt", "n");
+        x::remove_file(sub + "/old.txt");
+        x::write_file(test_dir + "/unwatched.txt", "u");
+
+        auto until = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+        while (std::chrono::steady_clock::now() < until) {
+            {
+                std::lock_guard lk(m);
+                if (seen.size() >= 3) break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        // let a late batch land before checking
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        w.stop();
+        EXPECT_FALSE(w.is_running());
+
+        std::lock_guard lk(m);
+        EXPECT_EQ(seen.size(), 3) << "poll " << poll;
+        EXPECT_EQ(seen[test_file], WatchEvent::Modified);
+        EXPECT_EQ(seen[sub + "/new.txt"], WatchEvent::Created);
+        EXPECT_EQ(seen[sub + "/old.txt"], WatchEvent::Removed);
+        EXPECT_FALSE(seen.contains(test_dir + "/unwatched.txt"));
+        EXPECT_LE(batches, 3);
+        x::remove_dir(sub);
+    }
+}
+
+#ifdef __linux__
+// inotify watches held by this process, from /proc/self/fdinfo
+static size_t inotify_watches() {
+    size_t n = 0;
+    for (auto& e : fs::directory_iterator("/proc/self/fd")) {
+        std::error_code ec;
+        if (fs::read_symlink(e.path(), ec).string() != "anon_inode:inotify") continue;
+        for (auto& line : x::split(x::read_file("/proc/self/fdinfo/" + e.path().filename().string()), "\n"))
+            n += line.starts_with("inotify wd:");
+    }
+    return n;
+}
+
+TEST_F(FilesystemTest, TestFileWatcherRemove) {
+    str sub = test_dir + "/watched";
+    x::create_dir(sub);
+    x::write_file(sub + "/a.txt", "a");
+    x::write_file(sub + "/b.txt", "b");
+
+    x::FileWatcher w;
+    w.start([](const _vec<x::FileEvent>&) {});
+    ASSERT_FALSE(w.polling());
+    EXPECT_EQ(inotify_watches(), 0);
+    // one watch on the directory, shared by the files in it
+    w.add(sub + "/a.txt");
+    w.add(sub + "/b.txt");
+    w.add(sub + "/b.txt");
+    w.add(sub);
+    EXPECT_EQ(inotify_watches(), 1);
+    w.remove(sub + "/a.txt");
+    w.remove(sub);
+    EXPECT_EQ(inotify_watches(), 1);
+    w.remove(sub + "/b.txt");
+    EXPECT_EQ(inotify_watches(), 0);
+    // added and removed over and over : nothing accumulates
+    for (int i = 0; i < 100; ++i) {
+        w.add(sub);
+        w.remove(sub);
+    }
+    EXPECT_EQ(inotify_watches(), 0);
+    w.stop();
 }
+#endif
 
 TEST_F(FilesystemTest, TestPathOperations) {
     _vec<str> parts = {"a", "b", "c.txt"};
@@ -169,3 +615,88 @@ TEST_F(FilesystemTest, TestFileTime) {
     str nonexistent_time = x::file_time("nonexistent_file");
     EXPECT_TRUE(nonexistent_time.empty());
 }
+
+TEST_F(FilesystemTest, TestAppendLog) {
+    str base = test_dir + "/events";
+    {
+        x::AppendLog log(base, {.segment_size = 4096, .sync_ms = 5});
+        _vec<std::thread> ts;
+        for (u32 t = 0; t < 4; ++t) {
+            ts.emplace_back([&log, t] {
+                for (u32 i = 0; i < 500; ++i) {
+                    u64 seq = log.append(_fmt("t{} r{}", t, i));
+                    if (i % 100 == 0) log.wait(seq);
+                }
+            });
+        }
+        for (auto& t : ts) t.join();
+        log.flush();
+        EXPECT_EQ(log.appended(), 2000);
+        EXPECT_EQ(log.durable(), 2000);
+    }
+    EXPECT_GT(x::AppendLog::segments(base).size(), 1);
+
+    // per writer order is kept across batches and segments
+    std::map<str, u32> next;
+    u64 n = x::AppendLog::replay(base, [&](sView rec) {
+        auto sp = rec.find(' ');
+        str  t  = str(rec.substr(0, sp));
+        EXPECT_EQ(x::parse<u32>(rec.substr(sp + 2)), next[t]++);
+    });
+    EXPECT_EQ(n, 2000);
+    EXPECT_EQ(x::AppendLog::replay(base, [](sView) { return false; }), 1);
+
+    // reopening starts a new segment; a torn tail ends only its own segment
+    size_t before = x::AppendLog::segments(base).size();
+    {
+        x::AppendLog log(base, {.sync = false});
+        log.append("last");
+        log.append(str(100, 'x'));
+        log.flush();
+    }
+    auto segs = x::AppendLog::segments(base);
+    ASSERT_EQ(segs.size(), before + 1);
+    std::filesystem::resize_file(segs.back().second, 8 + 4 + 8 + 50);
+    str last;
+    EXPECT_EQ(x::AppendLog::replay(base, [&](sView rec) { last = rec; }), 2001);
+    EXPECT_EQ(last, "last");
+
+    // waiters racing close() see their records synced by the final drain :
+    // only append() after close() fails
+    {
+        x::AppendLog log(base, {.sync_ms = 60000});
+        std::atomic<u32> thrown = 0;
+        _vec<std::thread> ts;
+        for (u32 t = 0; t < 4; ++t) {
+            ts.emplace_back([&, t] {
+                for (;;) {
+                    u64 seq = 0;
+                    try {
+                        seq = log.append("pending");
+                    } catch (const std::runtime_error&) {
+                        return;
+                    }
+                    if (t == 0) continue;   // keeps the writer busy with batches
+                    try {
+                        log.wait(seq);
+                    } catch (const std::runtime_error&) {
+                        ++thrown;
+                        return;
+                    }
+                }
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        log.close();
+        for (auto& t : ts) t.join();
+        EXPECT_EQ(thrown, 0);
+        EXPECT_EQ(log.durable(), log.appended());
+        EXPECT_NO_THROW(log.wait(log.appended()));
+        EXPECT_THROW(log.wait(log.appended() + 1), std::runtime_error);
+    }
+
+    x::AppendLog closed;
+    EXPECT_FALSE(closed.is_open());
+    EXPECT_THROW(closed.append("x"), std::runtime_error);
+    EXPECT_THROW(closed.wait(1), std::runtime_error);
+}
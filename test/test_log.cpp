@@ -0,0 +1,190 @@
+#include "../x.hpp"
+#include <gtest/gtest.h>
+
+using namespace x;
+
+namespace {
+// collects what the writer emits, one entry per line
+struct Capture {
+    std::mutex      m;
+    _vec<str>       lines;
+
+    std::function<void(sView)> sink() {
+        return [this](sView batch) {
+            std::lock_guard<std::mutex> lock(m);
+            for (auto line : splitter(batch, "\n"))
+                if (!line.empty()) lines.emplace_back(line);
+        };
+    }
+};
+
+// stops the logger on scope exit; declared after what the sink captures, so
+// the writer is gone before those locals are
+struct StopLog {
+    ~StopLog() { Log::instance().stop(); }
+};
+
+LogConfig quiet(Capture& cap) {
+    LogConfig cfg;
+    cfg.console = false;
+    cfg.level   = LogLevel::Debug;
+    cfg.sink    = cap.sink();
+    return cfg;
+}
+}
+
+class LogTest : public ::testing::Test {
+protected:
+    void TearDown() override { Log::instance().start(); }
+};
+
+TEST_F(LogTest, FormatsOnWriterThread) {
+    Capture cap;
+    StopLog stop;
+    Log::instance().start(quiet(cap));
+    str name = "ann";
+    u32 line = __LINE__ + 1;
+    _log_info("user {} id={} score={:.1f}", name, 42, 9.5);
+    _log_debug("{}", "debug line");
+    _log_trace("filtered out");
+    Log::instance().flush();
+
+    ASSERT_EQ(cap.lines.size(), 2);
+    EXPECT_TRUE(endWith(cap.lines[0], _fmt("INFO  test_log.cpp:{} user ann id=42 score=9.5", line))) << cap.lines[0];
+    EXPECT_TRUE(contain(cap.lines[1], " DEBUG test_log.cpp:"));
+    EXPECT_TRUE(endWith(cap.lines[1], " debug line"));
+    // "YYYY-MM-DD HH:MM:SS.ffffff "
+    EXPECT_EQ(cap.lines[0][4], '-');
+    EXPECT_EQ(cap.lines[0][19], '.');
+    EXPECT_EQ(cap.lines[0][26], ' ');
+}
+
+TEST_F(LogTest, ArgumentsAreCopied) {
+    Capture cap;
+    StopLog stop;
+    Log::instance().start(quiet(cap));
+    {
+        str temp = "temporary";
+        char buf[16] = "stack";
+        _log_info("{} {} {}", temp, buf, sView(temp).substr(0, 4));
+        temp.assign("overwritten");
+        std::strcpy(buf, "gone");
+    }
+    // arguments that do not fit a slot are formatted on the calling thread
+    str big(300, 'b');
+    _log_info("{}{}", big, big);
+    Log::instance().flush();
+    ASSERT_EQ(cap.lines.size(), 2);
+    EXPECT_TRUE(endWith(cap.lines[0], " temporary stack temp"));
+    EXPECT_TRUE(endWith(cap.lines[1], big + big));
+}
+
+TEST_F(LogTest, ManyThreads) {
+    Capture cap;
+    StopLog stop;
+    Log::instance().start(quiet(cap));
+    _vec<std::thread> threads;
+    for (i32 t = 0; t < 4; ++t) {
+        threads.emplace_back([t] {
+            for (i32 i = 0; i < 5000; ++i)
+                _log_info("t{} #{}", t, i);
+        });
+    }
+    for (auto& t : threads) t.join();
+    Log::instance().flush();
+    EXPECT_EQ(cap.lines.size(), 20000);
+    EXPECT_EQ(Log::instance().dropped(), 0);
+}
+
+TEST_F(LogTest, FullRingWakesWriter) {
+    // a full ring drains right away, not on the next flush_ms tick
+    Capture cap;
+    StopLog stop;
+    LogConfig cfg = quiet(cap);
+    cfg.flush_ms  = 10000;
+    cfg.ring_size = 64;
+    Log::instance().start(cfg);
+    auto t0 = std::chrono::steady_clock::now();
+    for (i32 i = 0; i < 20000; ++i)
+        _log_info("#{}", i);
+    EXPECT_LT(std::chrono::steady_clock::now() - t0, std::chrono::seconds(2));
+    Log::instance().flush();
+    EXPECT_EQ(cap.lines.size(), 20000);
+}
+
+TEST_F(LogTest, OverflowCount) {
+    Capture cap;
+    std::atomic<bool> entered{false}, release{false};
+    StopLog stop;
+    LogConfig cfg = quiet(cap);
+    cfg.overflow  = LogOverflow::Count;
+    cfg.ring_size = 4;
+    cfg.sink = [&, inner = cap.sink()](sView batch) {
+        entered = true;
+        while (!release) std::this_thread::yield();
+        inner(batch);
+    };
+    Log::instance().start(cfg);
+    u64 before = Log::instance().dropped();
+
+    std::thread([&] {
+        _log_warn("first");
+        while (!entered) std::this_thread::yield();   // writer is now stuck in the sink
+        for (i32 i = 0; i < 100; ++i)
+            _log_warn("msg {}", i);
+        release = true;
+    }).join();
+    Log::instance().flush();
+
+    u64 lost = Log::instance().dropped() - before;
+    EXPECT_GE(lost, 96);
+    EXPECT_EQ(cap.lines.size(), 1 + (100 - lost) + 1);
+    EXPECT_EQ(cap.lines.back(), _fmt("x::Log dropped {} messages", lost));
+}
+
+#ifndef _WIN32
+TEST_F(LogTest, CrashHandlerChains) {
+    // pending records reach the file, then the handler installed before runs
+    str path = "test_log_crash.log";
+    remove_file(path);
+    ::testing::GTEST_FLAG(death_test_style) = "threadsafe";
+    EXPECT_EXIT({
+        std::signal(SIGABRT, [](int) { std::_Exit(7); });
+        LogConfig cfg;
+        cfg.console  = false;
+        cfg.file     = path;
+        cfg.flush_ms = 10000;
+        Log::instance().start(cfg);
+        Log::instance().install_crash_handler();
+        _log_error("before crash");
+        std::raise(SIGABRT);
+    }, ::testing::ExitedWithCode(7), "");
+    EXPECT_TRUE(contain(read_file(path), "before crash"));
+    remove_file(path);
+}
+#endif
+
+TEST_F(LogTest, RotatingFile) {
+    str dir = "test_log_temp";
+    create_dir(dir);
+    LogConfig cfg;
+    cfg.console       = false;
+    cfg.file          = join_path({dir, "app.log"});
+    cfg.max_file_size = 1024;
+    cfg.max_files     = 2;
+    cfg.flush_ms      = 1;
+    Log::instance().start(cfg);
+    for (i32 i = 0; i < 200; ++i) {
+        _log_error("line {:04}", i);
+        if (i % 10 == 0) Log::instance().flush();
+    }
+    Log::instance().stop();
+
+    EXPECT_TRUE(exists(cfg.file));
+    EXPECT_TRUE(exists(cfg.file + ".1"));
+    EXPECT_TRUE(exists(cfg.file + ".2"));
+    EXPECT_FALSE(exists(cfg.file + ".3"));
+    EXPECT_LE(file_size(cfg.file), 1024 + 128);
+    EXPECT_TRUE(contain(read_file(cfg.file), "line 0199"));
+    remove_dir(dir);
+}
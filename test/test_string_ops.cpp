@@ -17,12 +17,115 @@ TEST(StringOpsTest, SplitStringDelimiter) {
     EXPECT_EQ(parts[2], "cpp");
 }
 
+TEST(StringOpsTest, SplitView) {
+    std::string line = "hello,world,,cpp";
+    auto parts = x::split_view(line, ",");
+    EXPECT_EQ(parts.size(), 4);
+    EXPECT_EQ(parts[0], "hello");
+    EXPECT_EQ(parts[2], "");
+    EXPECT_EQ(parts[3], "cpp");
+    EXPECT_EQ(parts[0].data(), line.data()); // no copy
+
+    EXPECT_EQ(x::split_view("a::b", "::").size(), 2);
+    EXPECT_TRUE(x::split_view("hello", ",").empty());
+    EXPECT_TRUE(x::split_view("", ",").empty());
+    EXPECT_TRUE(x::split_view("a,b", "").empty());
+}
+
+TEST(StringOpsTest, Splitter) {
+    std::vector<std::string_view> fields;
+    for (auto f : x::splitter("a,b,,c,", ","))
+        fields.push_back(f);
+    ASSERT_EQ(fields.size(), 5);
+    EXPECT_EQ(fields[0], "a");
+    EXPECT_EQ(fields[2], "");
+    EXPECT_EQ(fields[3], "c");
+    EXPECT_EQ(fields[4], "");
+
+    // same fields as split
+    auto ref = x::split("hello::world::cpp", "::");
+    auto sp  = x::splitter("hello::world::cpp", "::");
+    EXPECT_TRUE(std::ranges::equal(sp, ref));
+
+    // usable with std::ranges / views
+    static_assert(std::ranges::forward_range<x::Splitter>);
+    EXPECT_EQ(std::ranges::distance(x::splitter("1|2|3", "|")), 3);
+    auto firsts = x::splitter("x1,y2,z3", ",") | std::views::take(2);
+    EXPECT_EQ(*std::ranges::next(firsts.begin()), "y2");
+
+    EXPECT_TRUE(x::splitter("hello", ",").empty());
+    EXPECT_TRUE(x::splitter("", ",").empty());
+    EXPECT_TRUE(x::splitter("a,b", "").empty());
+}
+
+TEST(StringOpsTest, FindByte) {
+    EXPECT_EQ(x::find_byte("a,b,c", ','), 1);
+    EXPECT_EQ(x::find_byte("a,b,c", ',', 2), 3);
+    EXPECT_EQ(x::find_byte("a,b,c", '|'), std::string_view::npos);
+    EXPECT_EQ(x::find_byte("", ','), std::string_view::npos);
+    EXPECT_EQ(x::find_byte("a,b", ',', 10), std::string_view::npos);
+
+    // every length / offset / match position across the vector widths
+    std::string buf(300, 'a');
+    for (size_t len = 0; len < 200; ++len) {
+        for (size_t hit = 0; hit <= len; ++hit) {
+            std::string_view sv(buf.data() + 3, len);
+            if (hit < len) buf[3 + hit] = '\t';
+            EXPECT_EQ(x::find_byte(sv, '\t'), sv.find('\t'));
+            EXPECT_EQ(x::find_byte(sv, '\t', len / 2), sv.find('\t', len / 2));
+#ifdef X_SIMD_X86
+            auto e = sv.data() + sv.size();
+            auto expect = hit < len ? sv.data() + hit : e;
+            EXPECT_EQ(x::detail::find_byte_sse2(sv.data(), e, '\t'), expect);
+            if (x::detail::cpu_has_avx2()) {
+                EXPECT_EQ(x::detail::find_byte_avx2(sv.data(), e, '\t'), expect);
+            }
+#endif
+            if (hit < len) buf[3 + hit] = 'a';
+        }
+    }
+}
+
 TEST(StringOpsTest, JoinStrings) {
     std::vector<std::string> parts = {"hello", "world", "cpp"};
     auto joined = x::join(parts, ", ");
     EXPECT_EQ(joined, "hello, world, cpp");
 }
 
+TEST(StringOpsTest, JoinProjection) {
+    std::vector<std::string_view> views = {"a", "bb", "ccc"};
+    EXPECT_EQ(x::join(views, "|"), "a|bb|ccc");
+    EXPECT_EQ(x::join_size(views, "|"), 8);
+
+    const char* cstrs[] = {"x", "y"};
+    EXPECT_EQ(x::join(cstrs, ""), "xy");
+
+    // formattable elements
+    std::vector<int> ids = {1, 22, 333};
+    EXPECT_EQ(x::join(ids, ", "), "1, 22, 333");
+    EXPECT_EQ(x::join(std::vector<double>{0.5}, ","), "0.5");
+
+    // projection : member and lambda
+    struct User { std::string name; int age; };
+    std::vector<User> users = {{"ann", 30}, {"bob", 41}};
+    EXPECT_EQ(x::join(users, ",", &User::name), "ann,bob");
+    EXPECT_EQ(x::join(users, ",", &User::age), "30,41");
+    EXPECT_EQ(x::join(users, ";", [](const User& u) { return x::upper(u.name); }), "ANN;BOB");
+
+    // views
+    EXPECT_EQ(x::join(ids | std::views::filter([](int i) { return i > 1; }), "+"), "22+333");
+    EXPECT_EQ(x::join(x::splitter("a,b,c", ","), "/"), "a/b/c");
+
+    // into a caller buffer
+    char buf[32];
+    auto end = x::join_to(buf, views, ", ");
+    EXPECT_EQ(std::string_view(buf, end - buf), "a, bb, ccc");
+    std::string out = "ids=";
+    x::join_to(std::back_inserter(out), ids, ",");
+    EXPECT_EQ(out, "ids=1,22,333");
+    EXPECT_EQ(x::join(std::vector<int>{}, ","), "");
+}
+
 TEST(StringOpsTest, EdgeCases) {
     auto empty = x::split("", ",");
     EXPECT_TRUE(empty.empty());
@@ -41,6 +144,42 @@ TEST(StringOpsTest, Trim) {
     EXPECT_EQ(x::trim(""), "");
 }
 
+TEST(StringOpsTest, TrimView) {
+    std::string s = " \t key = value \r\n";
+    auto v = x::trim_view(s);
+    EXPECT_EQ(v, "key = value");
+    EXPECT_EQ(v.data(), s.data() + 3);
+    EXPECT_EQ(x::ltrim(s), "key = value \r\n");
+    EXPECT_EQ(x::rtrim(s), " \t key = value");
+    EXPECT_EQ(x::trim_view("   "), "");
+    EXPECT_EQ(x::trim_view(""), "");
+    EXPECT_EQ(x::trim_view("\v\fx"), "x");
+
+    x::trim_inplace(s);
+    EXPECT_EQ(s, "key = value");
+    std::string same = "same";
+    x::trim_inplace(same);
+    EXPECT_EQ(same, "same");
+    std::string blank = " \n ";
+    x::trim_inplace(blank);
+    EXPECT_EQ(blank, "");
+}
+
+TEST(StringOpsTest, TrimAll) {
+    std::vector<std::string_view> lines = {"  a ", "b", "\tc\t", "   "};
+    x::trim_all(lines);
+    EXPECT_EQ(lines, (std::vector<std::string_view>{"a", "b", "c", ""}));
+
+    // large enough to fan out over threads
+    std::vector<std::string> owned(100000);
+    for (size_t i = 0; i < owned.size(); ++i)
+        owned[i] = std::string(i % 3, ' ') + std::to_string(i) + std::string(i % 5, '\t');
+    std::vector<std::string_view> views(owned.begin(), owned.end());
+    x::trim_all(views, 4);
+    for (size_t i = 0; i < views.size(); ++i)
+        ASSERT_EQ(views[i], std::to_string(i));
+}
+
 TEST(StringOpsTest, Replace) {
     EXPECT_EQ(x::replace("hello world", "world", "cpp"), "hello cpp");
     EXPECT_EQ(x::replace("banana", "na", "no"), "banono");
@@ -48,6 +187,50 @@ TEST(StringOpsTest, Replace) {
     EXPECT_EQ(x::replace("", "x", "y"), "");
 }
 
+TEST(StringOpsTest, ReplaceEdgeCases) {
+    EXPECT_EQ(x::replace("aaa", "a", "aa"), "aaaaaa");
+    EXPECT_EQ(x::replace("aaaa", "aa", "b"), "bb");
+    EXPECT_EQ(x::replace("a,b,c", ",", ""), "abc");
+    EXPECT_EQ(x::replace("ab", "", "-"), "-a-b-");
+    EXPECT_EQ(x::replace("ab", "", ""), "ab");
+}
+
+TEST(StringOpsTest, ReplaceMany) {
+    x::ReplaceSet html{{"&", "&amp;"}, {"<", "&lt;"}, {">", "&gt;"}, {"\"", "&quot;"}};
+    EXPECT_EQ(html.size(), 4);
+    // replaced text is not rescanned ("&lt;" does not become "&amp;lt;")
+    EXPECT_EQ(x::replace_many("<a href=\"x\">&</a>", html),
+              "&lt;a href=&quot;x&quot;&gt;&amp;&lt;/a&gt;");
+    EXPECT_EQ(html.apply("plain"), "plain");
+    EXPECT_EQ(html.apply(""), "");
+
+    // leftmost-longest, no overlap
+    EXPECT_EQ(x::replace_many("abcd", {{"ab", "1"}, {"bcd", "2"}, {"cd", "3"}}), "13");
+    EXPECT_EQ(x::replace_many("abcd", {{"a", "1"}, {"abc", "2"}}), "2d");
+    EXPECT_EQ(x::replace_many("she sells", {{"he", "HE"}, {"she", "SHE"}, {"s", "$"}}),
+              "SHE $ell$");
+    EXPECT_EQ(x::replace_many("aaaa", {{"aa", "b"}}), "bb");
+    // nested patterns, and a short match kept after a longer prefix dies
+    EXPECT_EQ(x::replace_many(std::string(10, 'a'), {{"a", "1"}, {"aa", "2"}, {"aaa", "3"}}), "3331");
+    EXPECT_EQ(x::replace_many("abcdx", {{"ab", "1"}, {"cd", "2"}, {"abcde", "3"}}), "12x");
+    EXPECT_EQ(x::replace_many("abcdex", {{"ab", "1"}, {"cd", "2"}, {"abcde", "3"}}), "3x");
+
+    // same result as one replace per pattern when patterns do not interact
+    std::string text = "user=root; pass=secret; token=abc123";
+    std::string ref = x::replace(x::replace(x::replace(text, "root", "***"), "secret", "***"), "abc123", "***");
+    EXPECT_EQ(x::replace_many(text, {{"root", "***"}, {"secret", "***"}, {"abc123", "***"}}), ref);
+
+    // reusable, rebuild after add, last replacement wins
+    x::ReplaceSet rs;
+    rs.add("a", "1").add("", "x").add("a", "2");
+    EXPECT_EQ(rs.size(), 1);
+    EXPECT_THROW(rs.apply("a"), std::runtime_error);
+    rs.build();
+    EXPECT_EQ(rs.apply("banana"), "b2n2n2");
+    EXPECT_EQ(rs.apply("cab"), "c2b");
+    EXPECT_EQ(x::ReplaceSet{}.apply("abc"), "abc");
+}
+
 TEST(StringOpsTest, Reverse) {
     EXPECT_EQ(x::reverse("hello"), "olleh");
     EXPECT_EQ(x::reverse(""), "");
@@ -64,6 +247,49 @@ TEST(StringOpsTest, UpperLower) {
     EXPECT_EQ(x::lower("123"), "123");
 }
 
+TEST(StringOpsTest, UpperLowerInplace) {
+    std::string h = "Content-Type: Text/HTML; charset=UTF-8 [@`{~] caf\xc3\xa9";
+    std::string u = h, l = h;
+    x::upper_inplace(u);
+    x::lower_inplace(l);
+    EXPECT_EQ(u, "CONTENT-TYPE: TEXT/HTML; CHARSET=UTF-8 [@`{~] CAF\xc3\xa9");
+    EXPECT_EQ(l, "content-type: text/html; charset=utf-8 [@`{~] caf\xc3\xa9");
+
+    // every byte value, every tail length, against the C locale
+    std::string all;
+    for (int i = 0; i < 256 * 3 + 17; ++i) all += char(i);
+    for (size_t n : {0, 1, 15, 16, 31, 32, 33, 63, 64, 65, 200, 785}) {
+        std::string a = all.substr(0, n), ua = a, la = a;
+        x::upper_inplace(ua);
+        x::lower_inplace(la);
+        for (size_t i = 0; i < n; ++i) {
+            char c = a[i];
+            EXPECT_EQ(ua[i], (c >= 'a' && c <= 'z') ? char(c - 32) : c);
+            EXPECT_EQ(la[i], (c >= 'A' && c <= 'Z') ? char(c + 32) : c);
+        }
+        EXPECT_TRUE(x::same_nocase(ua, la));
+    }
+
+    EXPECT_EQ(x::upper("hello", std::locale::classic()), "HELLO");
+    EXPECT_EQ(x::lower("HELLO", std::locale::classic()), "hello");
+}
+
+TEST(StringOpsTest, SameNoCaseLong) {
+    std::string a = "ACCEPT-ENCODING: GZIP, DEFLATE, BR; X-FORWARDED-FOR: 10.0.0.1";
+    std::string b = x::lower(a);
+    EXPECT_TRUE(x::same_nocase(a, b));
+    EXPECT_TRUE(x::same_nocase(std::string_view(a), "accept-encoding: gzip, deflate, br; x-forwarded-for: 10.0.0.1"));
+    for (size_t i = 0; i < b.size(); ++i) {
+        std::string c = b;
+        c[i] ^= 0x01;
+        EXPECT_FALSE(x::same_nocase(a, c)) << i;
+    }
+    // only letters fold : '@' (0x40) and '`' (0x60) differ
+    EXPECT_FALSE(x::same_nocase("@", "`"));
+    EXPECT_FALSE(x::same_nocase("[", "{"));
+    EXPECT_TRUE(x::same_nocase("Hello", "hELLO", std::locale::classic()));
+}
+
 TEST(StringOpsTest, StartEndWith) {
     EXPECT_TRUE(x::startWith("hello world", "hello"));
     EXPECT_FALSE(x::startWith("hello world", "world"));
@@ -80,6 +306,39 @@ TEST(StringOpsTest, Contain) {
     EXPECT_TRUE(x::contain("x", "x"));
 }
 
+TEST(StringOpsTest, Pattern) {
+    std::string text = "GET /index.html 200; GET /api 404; POST /api 200";
+    x::Pattern get("GET");
+    EXPECT_TRUE(get.contains(text));
+    EXPECT_EQ(get.count(text), 2);
+    EXPECT_EQ(get.find_all(text), (std::vector<size_t>{0, 21}));
+    EXPECT_EQ(get.find(text, 1), 21);
+    EXPECT_TRUE(x::contain(text, x::Pattern("POST")));
+    EXPECT_FALSE(x::Pattern("PUT").contains(text));
+    EXPECT_EQ(x::Pattern(";").count(text), 2);
+    EXPECT_EQ(x::Pattern("aa").count("aaaaa"), 2);     // non-overlapping
+    EXPECT_EQ(x::Pattern("").count(text), 0);
+    EXPECT_TRUE(x::Pattern("").contains(text));
+    EXPECT_FALSE(x::Pattern("x").contains(""));
+
+    // every needle length / strategy agrees with std::string_view::find
+    std::string hay;
+    for (int i = 0; i < 3000; ++i) hay += char('a' + (i * 7 + i / 13) % 5);
+    for (size_t n : {1, 2, 3, 8, 16, 31, 32, 33, 40, 64, 100}) {
+        for (size_t at : {0, 1, 15, 17, 500, 1234, 2999 - 100}) {
+            std::string_view needle(hay.data() + at, n);
+            x::Pattern p(needle);
+            x::Pattern copy = p;
+            for (size_t pos : {0, 1, 33, 777, 2000, 2990, 3000, 3001}) {
+                EXPECT_EQ(p.find(hay, pos), std::string_view(hay).find(needle, pos)) << n << " " << at << " " << pos;
+                EXPECT_EQ(copy.find(hay, pos), p.find(hay, pos));
+            }
+        }
+        std::string missing(n, 'z');
+        EXPECT_EQ(x::Pattern(missing).find(hay), std::string_view::npos);
+    }
+}
+
 TEST(StringOpsTest, IsDigit) {
     EXPECT_TRUE(x::is_digit("12345"));
     EXPECT_FALSE(x::is_digit("123a45"));
@@ -91,6 +350,44 @@ TEST(StringOpsTest, IsDigit) {
     EXPECT_FALSE(x::is_digit("١٢٣"));  // Arabic numerals
 }
 
+TEST(StringOpsTest, Parse) {
+    EXPECT_EQ(x::parse<int>("12345"), 12345);
+    EXPECT_EQ(x::parse<int>("-42"), -42);
+    EXPECT_EQ(x::parse<int>("+7"), 7);
+    EXPECT_EQ(x::parse<x::i64>("9223372036854775807"), 9223372036854775807LL);
+    EXPECT_EQ(x::parse<x::u8>("255"), 255);
+    EXPECT_DOUBLE_EQ(*x::parse<double>("1.25"), 1.25);
+    EXPECT_DOUBLE_EQ(*x::parse<double>("-3e2"), -300.0);
+    EXPECT_FLOAT_EQ(*x::parse<float>("0.5"), 0.5f);
+
+    EXPECT_FALSE(x::parse<int>(""));
+    EXPECT_FALSE(x::parse<int>("+"));
+    EXPECT_FALSE(x::parse<int>("+-5"));
+    EXPECT_FALSE(x::parse<int>("++5"));
+    EXPECT_FALSE(x::parse<unsigned>("+-5"));
+    EXPECT_FALSE(x::parse<double>("+-1.5"));
+    EXPECT_FALSE(x::parse<int>("12a"));
+    EXPECT_FALSE(x::parse<int>(" 12"));
+    EXPECT_FALSE(x::parse<int>("1.5"));
+    EXPECT_FALSE(x::parse<x::u8>("256"));      // out of range
+    EXPECT_FALSE(x::parse<unsigned>("-1"));
+    EXPECT_FALSE(x::parse<double>("1.2.3"));
+}
+
+TEST(StringOpsTest, ParseColumn) {
+    std::string line = "1,2,x,-4,5";
+    auto col = x::split_view(line, ",");
+    std::vector<int> out(col.size());
+    EXPECT_EQ(x::parse_to<int>(col, out, -1), 4);
+    EXPECT_EQ(out, (std::vector<int>{1, 2, -1, -4, 5}));
+
+    auto d = x::parse_column<double>(x::split_view("0.5|1|bad", "|"));
+    ASSERT_EQ(d.size(), 3);
+    EXPECT_DOUBLE_EQ(d[0], 0.5);
+    EXPECT_DOUBLE_EQ(d[1], 1.0);
+    EXPECT_DOUBLE_EQ(d[2], 0.0);
+}
+
 TEST(StringOpsTest, SameNoCase) {
     EXPECT_TRUE(x::same_nocase("hello", "HELLO"));
     EXPECT_TRUE(x::same_nocase("HELLO", "hello"));
@@ -125,3 +422,44 @@ TEST(StringOpsTest, VariadicPrint) {
     x::veprtln("Error: {}", "message");
     EXPECT_EQ(testing::internal::GetCapturedStderr(), "Error: message\n");
 }
+
+TEST(StringOpsTest, StrBuf) {
+    x::StrBuf b;
+    b.append("id=").append_int(42).append(',').append_int(-7LL)
+     .append_fmt(" t={:.2f} {}", 1.5, "ok").append(" f=").append_float(0.25);
+    EXPECT_EQ(b.view(), "id=42,-7 t=1.50 ok f=0.25");
+    EXPECT_FALSE(b.on_heap());
+    EXPECT_EQ(x::vfmt("[{}]", b), "[id=42,-7 t=1.50 ok f=0.25]");
+    EXPECT_EQ(_fmt("{:>4}", x::StrBuf<8>("ab")), "  ab");
+
+    b.clear();
+    b.append_float(3.14159, 2);
+    EXPECT_EQ(b.to_str(), "3.14");
+
+    // spill to the heap, keep content
+    x::StrBuf<16> small;
+    for (int i = 0; i < 10; ++i)
+        small.append_fmt("{:04}|", i);
+    EXPECT_TRUE(small.on_heap());
+    EXPECT_EQ(small.size(), 50);
+    EXPECT_TRUE(x::startWith(std::string(small.view()), "0000|0001|"));
+    small.append(small.view());
+    EXPECT_EQ(small.size(), 100);
+    small.append_fmt("{}", std::string(300, 'z'));
+    EXPECT_EQ(small.size(), 400);
+
+    // copy / move
+    x::StrBuf<16> moved = std::move(small);
+    EXPECT_EQ(moved.size(), 400);
+    EXPECT_TRUE(small.empty());
+    x::StrBuf<16> copy = moved;
+    EXPECT_EQ(copy.view(), moved.view());
+    x::StrBuf<16> inl("inline");
+    x::StrBuf<16> inl2 = std::move(inl);
+    EXPECT_EQ(inl2.view(), "inline");
+    EXPECT_FALSE(inl2.on_heap());
+
+    testing::internal::CaptureStdout();
+    _prtln("{}", inl2);
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "inline\n");
+}
@@ -22,6 +22,52 @@ TEST_F(UtilitiesTest, TestTimeFunctions) {
     EXPECT_GT(ts2, ts1);
 }
 
+TEST_F(UtilitiesTest, TestCycleClock) {
+    u64 ns0 = x::timestamp_ns();
+    u64 c0  = x::cycles();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    u64 c1  = x::cycles();
+    u64 ns1 = x::timestamp_ns();
+    EXPECT_GE(ns1 - ns0, 20'000'000u);
+    EXPECT_LT(ns1 - ns0, 2'000'000'000u);
+
+    // cycles and ns agree on the interval
+    u64 d = x::cycles_to_ns(c1 - c0);
+    EXPECT_GE(d, 19'000'000u);
+    EXPECT_LE(d, ns1 - ns0 + 1'000'000);
+    EXPECT_GT(x::cycles_per_ns(), 0.0);
+
+    // same clock in every unit
+    u64 us = x::timestamp_us();
+    u64 ms = x::timestamp_ms();
+    EXPECT_GE(us, ns1 / 1000);
+    EXPECT_GE(ms, ns1 / 1000000);
+    EXPECT_LT(ms - ns1 / 1000000, 1000u);
+
+    u64 prev = x::timestamp_ns();
+    for (int i = 0; i < 10000; ++i) {
+        u64 now = x::timestamp_ns();
+        EXPECT_GE(now, prev);
+        prev = now;
+    }
+
+    // re-anchored against the os clock : the offset does not grow, and
+    // crossing a re-anchor keeps it monotonic
+    x::calibrate_clock();
+    auto offset = [] { return i64(x::timestamp_ns()) - i64(x::detail::os_clock_ns()); };
+    i64  first  = offset(), worst = 0;
+    auto until  = std::chrono::steady_clock::now() + std::chrono::milliseconds(1200);
+    prev = x::timestamp_ns();
+    while (std::chrono::steady_clock::now() < until) {
+        u64 now = x::timestamp_ns();
+        EXPECT_GE(now, prev);
+        prev  = now;
+        worst = std::max(worst, std::abs(offset() - first));
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    EXPECT_LT(worst, 200'000);
+}
+
 TEST_F(UtilitiesTest, TestRandomNumbers) {
     // Test rand_int
     i32 num = x::rand_int(1, 100);
@@ -100,6 +146,63 @@ TEST_F(UtilitiesTest, TestRandomDistribution) {
     }
 }
 
+TEST_F(UtilitiesTest, TestRandomSeedAndFill) {
+    // same seed, same calls : same values
+    auto draw = [] {
+        x::seed_rand(42);
+        _vec<i32> ints(37);
+        _vec<f64> reals(13);
+        x::rand_fill(std::span(ints), -5, 5);
+        x::rand_fill(std::span(reals), 2.0, 3.0);
+        return std::make_pair(std::make_pair(ints, reals), std::make_pair(x::rand_int(0, 1000), x::rand_float()));
+    };
+    auto a = draw();
+    EXPECT_EQ(a, draw());
+    for (i32 v : a.first.first) { EXPECT_GE(v, -5); EXPECT_LE(v, 5); }
+    for (f64 v : a.first.second) { EXPECT_GE(v, 2.0); EXPECT_LT(v, 3.0); }
+    // the largest draw rounds up to max : kept just below it
+    EXPECT_EQ(2.0 + (1 - 0x1.0p-52) * 1.0, 3.0);
+    EXPECT_EQ(x::detail::rand_scale(1 - 0x1.0p-52, 2.0, 3.0), std::nextafter(3.0, 2.0));
+    EXPECT_EQ(x::detail::rand_scale(0.5, 2.0, 3.0), 2.5);
+
+    // degenerate, swapped and full ranges
+    EXPECT_EQ(x::rand_int(7, 7), 7);
+    i32 s = x::rand_int(10, 1);
+    EXPECT_GE(s, 1);
+    EXPECT_LE(s, 10);
+    _vec<i32> full(1000);
+    x::rand_fill(std::span(full), INT32_MIN, INT32_MAX);
+    EXPECT_TRUE(std::any_of(full.begin(), full.end(), [](i32 v) { return v < 0; }));
+    EXPECT_TRUE(std::any_of(full.begin(), full.end(), [](i32 v) { return v > 0; }));
+
+    // bulk fill is uniform too
+    _vec<i32> bulk(100000);
+    x::rand_fill(std::span(bulk), 0, 9);
+    std::vector<int> counts(10, 0);
+    for (i32 v : bulk) counts[v]++;
+    for (int c : counts) {
+        EXPECT_GT(c, 9000);
+        EXPECT_LT(c, 11000);
+    }
+
+    // Rng works with the standard algorithms, jump() gives a new stream
+    x::Rng r1(7), r2(7);
+    _vec<int> p1(20), p2(20);
+    std::iota(p1.begin(), p1.end(), 0);
+    p2 = p1;
+    std::shuffle(p1.begin(), p1.end(), r1);
+    std::shuffle(p2.begin(), p2.end(), r2);
+    EXPECT_EQ(p1, p2);
+    r2.jump();
+    EXPECT_NE(r1(), r2());
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_LT(r1.below(3), 3u);
+        i64 v = r1.range(-2, 2);
+        EXPECT_GE(v, -2);
+        EXPECT_LE(v, 2);
+    }
+}
+
 TEST_F(UtilitiesTest, TestClampEdgeCases) {
     // Test equal min/max
     EXPECT_EQ(x::clamp(5, 5, 5), 5);
@@ -127,3 +230,38 @@ TEST_F(UtilitiesTest, TestThreadIdUniqueness) {
         t.join();
     }
 }
+
+TEST_F(UtilitiesTest, TestHashBytes) {
+    // reference values of xxHash 0.8 XXH3 / crc-32c
+    EXPECT_EQ(x::hash_bytes(""), 0x2d06800538d394c2ull);
+    EXPECT_EQ(x::hash_bytes("abc"), 0x78af5f94892f3950ull);
+    EXPECT_EQ(x::hash_bytes("hello world"), 0xd447b1ea40e6988bull);
+    EXPECT_EQ(x::hash_bytes("abc", 42), 0xd8438def21bbdcc3ull);
+    EXPECT_EQ(x::hash_bytes128("hello world").hex(), "df8d09e93f874900a99b8775cc15b6c7");
+    EXPECT_EQ(x::hash_bytes128("").hex(), "99aa06d3014798d86001c324468d497f");
+    str big;
+    for (int i = 0; i < 1000; ++i) big += "0123456789";
+    EXPECT_EQ(x::hash_bytes(big), 0x2da683cfe7106d98ull);
+    EXPECT_NE(x::hash_bytes(big, 1), x::hash_bytes(big));
+
+    EXPECT_EQ(x::crc32c("123456789"), 0xe3069283u);
+    EXPECT_EQ(x::crc32c("6789", x::crc32c("12345")), 0xe3069283u);
+    EXPECT_EQ(x::crc32c(""), 0u);
+
+    // streaming matches one shot for every split and size class
+    for (size_t n : {0, 3, 16, 100, 240, 241, 256, 257, 1024, 1025, 5000}) {
+        sView  v(big.data(), n);
+        x::Hasher h(7);
+        for (size_t i = 0, step = 1; i < n; i += step, step = step * 2 + 1)
+            h.update(v.substr(i, step));
+        EXPECT_EQ(h.size(), n);
+        EXPECT_EQ(h.digest(), x::hash_bytes(v, 7)) << n;
+        EXPECT_EQ(h.digest128(), x::hash_bytes128(v, 7)) << n;
+    }
+
+    // tree mode : independent of threads, flat below one chunk
+    u64 t1 = x::hash_tree(big, {.chunk = 1000, .threads = 1});
+    EXPECT_EQ(x::hash_tree(big, {.chunk = 1000, .threads = 4}), t1);
+    EXPECT_NE(x::hash_tree(big, {.chunk = 2000}), t1);
+    EXPECT_EQ(x::hash_tree(big, {.chunk = 1 << 20}), x::hash_bytes(big));
+}
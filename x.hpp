@@ -42,14 +42,81 @@
 #include <any>
 #include <functional>
 #include <thread>
+#include <future>
 #include <map>
+#include <set>
 #include <unordered_map>
 #include <condition_variable>
 #include <mutex>
+#include <memory>
+#include <tuple>
+#include <csignal>
+#include <exception>
+#include <new>
+#include <cstdlib>
+#include <cerrno>
+#include <optional>
+#include <span>
+#include <charconv>
+#include <cmath>
+#include <locale>
+#include <atomic>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <barrier>
+#include <utility>
 #if __cplusplus >= 202302L
 #include <print>
 #endif
 
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <dirent.h>
+#include <poll.h>
+#include <climits>
+#endif
+#ifdef __linux__
+#include <sys/inotify.h>
+// batched file io through io_uring, raw syscalls (define X_NO_URING to disable)
+#if !defined(X_NO_URING) && __has_include(<linux/io_uring.h>)
+#define X_URING 1
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+// x86 simd kernels, picked at runtime (define X_NO_SIMD to disable)
+#if !defined(X_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+#define X_SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define X_TARGET_AVX2
+#define X_TARGET_SSE42
+#else
+#define X_TARGET_AVX2 __attribute__((target("avx2")))
+#define X_TARGET_SSE42 __attribute__((target("sse4.2")))
+#endif
+#endif
+
+// invariant tsc clock on x86-64 (define X_NO_TSC to use the os clock only)
+#if !defined(X_NO_TSC) && (defined(__x86_64__) || defined(_M_X64))
+#define X_TSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#include <cpuid.h>
+#endif
+#endif
+
 // ----------------------- macro define -----------------------
 #define _coto       const auto
 #define _vec        std::vector
@@ -58,10 +125,17 @@
 #define _fmt        std::format
 #define _unmap      std::unordered_map
 
-#define _excode_info(i)     _fmt("{}/{}/{}", \
-                            std::filesystem::path(__FILE__).filename().string(), \
-                            __LINE__, (i  == std::string("") ? __func__ : i))
+// "file.cpp/line/func" (or ".../tag"), built at compile time into a static
+// string_view; i must be a string literal
+#define _excode_info(i)     x::detail::code_tag<x::detail::make_code_info< \
+                            sizeof(__FILE__) + sizeof(i) + sizeof(X_FUNC) + 12>( \
+                            __FILE__, __LINE__, std::string_view(i).empty() ? X_FUNC : i)>::view()
 #define _code_info()        _excode_info("")
+#define _excode_id(i)       x::detail::code_tag<x::detail::make_code_info< \
+                            sizeof(__FILE__) + sizeof(i) + sizeof(X_FUNC) + 12>( \
+                            __FILE__, __LINE__, std::string_view(i).empty() ? X_FUNC : i)>::id
+#define _code_id()          _excode_id("")
+#define _file_name()        x::detail::base_name(__FILE__)
 #define _build_time()       (__DATE__ " " __TIME__)
 
 // concate define string or "str"
@@ -81,29 +155,83 @@ namespace std {
 }
 #endif
 
+// msvc's __func__ is not usable in constant expressions, __FUNCTION__ is a literal
+#ifdef _MSC_VER
+#define X_FUNC __FUNCTION__
+#else
+#define X_FUNC __func__
+#endif
+
+namespace x::detail {
+// ----------------------- code location -----------------------
+consteval std::string_view base_name(std::string_view path) {
+    auto p = path.find_last_of("/\\");
+    return p == std::string_view::npos ? path : path.substr(p + 1);
+}
+
+template<size_t N>
+struct CodeInfo {
+    char   data[N] {};
+    size_t size = 0;
+
+    constexpr void append(std::string_view s) { for (char c : s) data[size++] = c; }
+};
+
+template<size_t N>
+consteval CodeInfo<N> make_code_info(std::string_view file, unsigned line, std::string_view tag) {
+    CodeInfo<N> r;
+    r.append(base_name(file));
+    r.append("/");
+    char   digits[10];
+    size_t n = 0;
+    do { digits[n++] = char('0' + line % 10); line /= 10; } while (line);
+    while (n) r.data[r.size++] = digits[--n];
+    r.append("/");
+    // msvc's __FUNCTION__ is qualified ("Class::fn")
+    if (auto p = tag.rfind("::"); p != std::string_view::npos) tag.remove_prefix(p + 2);
+    r.append(tag);
+    return r;
+}
+
+// one static object per distinct location; id is fnv-1a of the text
+template<CodeInfo I>
+struct code_tag {
+    static constexpr auto value = I;
+    static constexpr std::uint64_t id = [] {
+        std::uint64_t h = 14695981039346656037ull;
+        for (size_t k = 0; k < I.size; ++k) h = (h ^ static_cast<unsigned char>(I.data[k])) * 1099511628211ull;
+        return h;
+    }();
+    static constexpr std::string_view view() noexcept { return {value.data, value.size}; }
+};
+
+// console sink, see "output" below
+inline void out_write(bool err, std::string_view s, bool newline);
+}
+
 #if __cplusplus < 202302L
 namespace std {
 template<typename... Args>
 inline void print(std::format_string<Args...> formt, Args&&... args) {
-    std::cout << std::format(formt, std::forward<Args>(args)...);
+    x::detail::out_write(false, std::format(formt, std::forward<Args>(args)...), false);
 }
 
 inline void print(const char* formt) {
-    std::cout << formt;
+    x::detail::out_write(false, formt, false);
 }
 
 template<typename... Args>
 inline void println(std::format_string<Args...> formt, Args&&... args) {
-    std::cout << std::format(formt, std::forward<Args>(args)...) << std::endl;
+    x::detail::out_write(false, std::format(formt, std::forward<Args>(args)...), true);
 }
 
 inline void println(const char* formt) {
-    std::cout << formt << std::endl;
+    x::detail::out_write(false, formt, true);
 }
 
 template<typename... Args>
 inline void println(const char* formt, Args&&... args) {
-    std::cout << std::vformat(formt, std::make_format_args(args...)) << std::endl;
+    x::detail::out_write(false, std::vformat(formt, std::make_format_args(args...)), true);
 }
 
 } // namespace std
@@ -147,327 +275,4985 @@ typedef const f64          cF64;
 typedef const str          cStr;
 typedef const sView      cSView;
 
+// ----------------------- output -----------------------
+// Stream   : std::cout / std::cerr, std::endl after each line (default)
+// Buffered : per-thread buffers, no flush per line; a buffer is written out
+//            past flush_size bytes, when older than flush_ms (on the next
+//            write, and by a background flusher every flush_ms so idle
+//            threads' lines show up too), on flush_output(), at thread exit
+//            and at exit
+// the bytes written are the same in both modes
+enum class OutMode : u8 { Stream, Buffered };
+
+struct OutPolicy {
+    OutMode mode       = OutMode::Stream;
+    size_t  flush_size = 64 << 10;
+    u64     flush_ms   = 100;       // 0 : no time based flush
+    bool    direct_fd  = false;     // write(1/2) instead of std::cout/cerr, in both modes
+};
+
+namespace detail {
+
+struct OutBuf;
+
+struct OutState {
+    std::atomic<u8>     mode{u8(OutMode::Stream)};
+    std::atomic<size_t> flush_size{64 << 10};
+    std::atomic<u64>    flush_ms{100};
+    std::atomic<bool>   direct_fd{false};
+    std::mutex          m;          // guards bufs
+    _vec<OutBuf*>       bufs;
+
+    // Buffered with flush_ms : writes out every buffer each flush_ms
+    std::mutex              flusher_m;
+    std::condition_variable flusher_cv;
+    std::thread             flusher;
+    bool                    flusher_stop = false;
+
+    ~OutState() { stop_flusher(); }
+
+    void stop_flusher() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(flusher_m);
+            flusher_stop = true;
+        }
+        flusher_cv.notify_all();
+        if (flusher.joinable()) flusher.join();
+    }
+
+    void start_flusher();
+};
+
+inline void flush_all_out() noexcept;
+
+inline OutState& out_state() {
+    static OutState st;
+    static const bool at_exit = (std::atexit([] {
+        out_state().stop_flusher();
+        flush_all_out();
+    }), true);
+    (void)at_exit;
+    return st;
+}
+
+inline void OutState::start_flusher() {
+    stop_flusher();
+    flusher_stop = false;
+    flusher = std::thread([this] {
+        std::unique_lock<std::mutex> lock(flusher_m);
+        while (!flusher_stop) {
+            auto ms = std::chrono::milliseconds(flush_ms.load(std::memory_order_relaxed));
+            if (flusher_cv.wait_for(lock, ms, [this] { return flusher_stop; })) break;
+            lock.unlock();
+            flush_all_out();
+            lock.lock();
+        }
+    });
+}
+
+inline u64 out_now_ms() noexcept {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline void out_sink(bool err, cSView& s, bool direct) noexcept {
+    if (s.empty()) return;
+    if (direct) {
+        const char* p = s.data();
+        size_t      n = s.size();
+        while (n > 0) {
+#ifdef _WIN32
+            int w = _write(err ? 2 : 1, p, unsigned(std::min<size_t>(n, 1 << 30)));
+#else
+            auto w = ::write(err ? 2 : 1, p, n);
+            if (w < 0 && errno == EINTR) continue;
+#endif
+            if (w <= 0) return;
+            p += w;
+            n -= size_t(w);
+        }
+        return;
+    }
+    auto& os = err ? std::cerr : std::cout;
+    os.write(s.data(), std::streamsize(s.size()));
+    os.flush();
+}
+
+// one per thread, registered so flush_output / exit can reach it
+struct OutBuf {
+    std::mutex m;
+    str        data[2];
+    u64        since[2] = {0, 0};
+
+    OutBuf() {
+        auto& st = out_state();
+        std::lock_guard<std::mutex> lock(st.m);
+        st.bufs.push_back(this);
+    }
+
+    ~OutBuf() {
+        flush();
+        auto& st = out_state();
+        std::lock_guard<std::mutex> lock(st.m);
+        std::erase(st.bufs, this);
+    }
+
+    void flush() noexcept {
+        std::lock_guard<std::mutex> lock(m);
+        flush_locked(out_state().direct_fd.load(std::memory_order_relaxed));
+    }
+
+    void flush_locked(bool direct) noexcept {
+        for (int i = 0; i < 2; ++i) {
+            out_sink(i == 1, data[i], direct);
+            data[i].clear();
+        }
+    }
+};
+
+inline OutBuf& out_buf() {
+    thread_local OutBuf buf;
+    return buf;
+}
+
+inline void flush_all_out() noexcept {
+    auto& st = out_state();
+    std::lock_guard<std::mutex> lock(st.m);
+    for (auto* b : st.bufs)
+        b->flush();
+}
+
+inline void out_write(bool err, std::string_view s, bool newline) {
+    auto& st = out_state();
+    if (st.mode.load(std::memory_order_relaxed) == u8(OutMode::Stream)) {
+        if (st.direct_fd.load(std::memory_order_relaxed)) {
+            // one write per line, so lines of other threads do not split it
+            if (!newline) return out_sink(err, s, true);
+            str line;
+            line.reserve(s.size() + 1);
+            line.append(s).push_back('\n');
+            return out_sink(err, line, true);
+        }
+        auto& os = err ? std::cerr : std::cout;
+        os << s;
+        if (newline) os << std::endl;
+        return;
+    }
+    auto& b = out_buf();
+    std::lock_guard<std::mutex> lock(b.m);
+    str& d = b.data[err];
+    u64 now = 0, flush_ms = st.flush_ms.load(std::memory_order_relaxed);
+    if (flush_ms) {
+        now = out_now_ms();
+        if (d.empty()) b.since[err] = now;
+    }
+    d += s;
+    if (newline) d += '\n';
+    if (d.size() >= st.flush_size.load(std::memory_order_relaxed) ||
+        (flush_ms && now - b.since[err] >= flush_ms))
+        b.flush_locked(st.direct_fd.load(std::memory_order_relaxed));
+}
+
+} // namespace detail
+
+// write out every thread's pending buffered output
+inline void flush_output() noexcept {
+    detail::flush_all_out();
+}
+
+// switch output mode, pending output is flushed first
+// x::set_output({.mode = x::OutMode::Buffered, .direct_fd = true});
+inline void set_output(const OutPolicy& p) {
+    auto& st = detail::out_state();
+    detail::flush_all_out();
+    std::cout.flush();
+    std::cerr.flush();
+    st.stop_flusher();
+    st.flush_size.store(std::max<size_t>(p.flush_size, 1));
+    st.flush_ms.store(p.flush_ms);
+    st.direct_fd.store(p.direct_fd);
+    st.mode.store(u8(p.mode));
+    if (p.mode == OutMode::Buffered && p.flush_ms) st.start_flusher();
+}
+
+inline OutPolicy output_policy() {
+    auto& st = detail::out_state();
+    return {OutMode(st.mode.load()), st.flush_size.load(), st.flush_ms.load(), st.direct_fd.load()};
+}
+
 // ----------------------- mini func -----------------------
+namespace detail {
+// text of a std::format_string (get() since P2508, .str for the old MSC shim)
+template<typename F>
+constexpr sView fmt_view(const F& ft) noexcept {
+    if constexpr (requires { ft.str; }) return ft.str;
+    else return ft.get();
+}
+} // namespace detail
+
 inline std::string vfmt(cStr& ft, auto&&... args){
     return std::vformat(ft, std::make_format_args(args...));
 }
 
+namespace detail {
+// formats into a per-thread scratch string, no allocation once it has grown
+inline void vout(bool err, bool newline, sView ft, std::format_args args) {
+    thread_local str buf;
+    buf.clear();
+    std::vformat_to(std::back_inserter(buf), ft, args);
+    out_write(err, buf, newline);
+}
+} // namespace detail
+
 inline void vprt(cStr& ft, auto&&... args) {
-    std::cout << std::vformat(ft, std::make_format_args(args...));
+    detail::vout(false, false, ft, std::make_format_args(args...));
 }
 
 inline void vprtln(cStr& ft, auto&&... args) {
-    std::cout << std::vformat(ft, std::make_format_args(args...)) << std::endl;
+    detail::vout(false, true, ft, std::make_format_args(args...));
 }
 
 inline void veprt(cStr& ft, auto&&... args) {
-    std::cerr << std::vformat(ft, std::make_format_args(args...));
+    detail::vout(true, false, ft, std::make_format_args(args...));
 }
 
 inline void veprtln(cStr& ft, auto&&... args) {
-    std::cerr << std::vformat(ft, std::make_format_args(args...)) << std::endl;
+    detail::vout(true, true, ft, std::make_format_args(args...));
+}
+
+// ----------------------- simd helpers -----------------------
+namespace detail {
+
+using find_byte_fn = const char* (*)(const char*, const char*, char) noexcept;
+
+inline const char* find_byte_scalar(const char* p, const char* e, char c) noexcept {
+    if (p >= e) return e;
+    auto r = static_cast<const char*>(std::memchr(p, c, size_t(e - p)));
+    return r ? r : e;
+}
+
+#ifdef X_SIMD_X86
+inline u32 match16(const char* p, __m128i n) noexcept {
+    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    return u32(_mm_movemask_epi8(_mm_cmpeq_epi8(v, n)));
+}
+
+inline const char* find_byte_sse2(const char* p, const char* e, char c) noexcept {
+    const size_t len = size_t(e - p);
+    if (len < 16) {
+        for (; p < e; ++p)
+            if (*p == c) return p;
+        return e;
+    }
+    const __m128i n = _mm_set1_epi8(c);
+    for (; e - p >= 16; p += 16)
+        if (u32 m = match16(p, n)) return p + std::countr_zero(m);
+    if (p == e) return e;
+    // overlapping load of the last 16 bytes, skip what was already scanned
+    u32 m = match16(e - 16, n) >> (16 - (e - p));
+    return m ? p + std::countr_zero(m) : e;
+}
+
+X_TARGET_AVX2
+inline u32 match32(const char* p, __m256i n) noexcept {
+    auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    return u32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, n)));
+}
+
+X_TARGET_AVX2
+inline const char* find_byte_avx2(const char* p, const char* e, char c) noexcept {
+    if (e - p < 32) return find_byte_sse2(p, e, c);
+    const __m256i n = _mm256_set1_epi8(c);
+    // delimiters are usually close, probe one vector before unrolling
+    if (u32 m = match32(p, n)) return p + std::countr_zero(m);
+    for (p += 32; e - p >= 64; p += 64) {
+        u32 m0 = match32(p, n);
+        u32 m1 = match32(p + 32, n);
+        if (m0 | m1)
+            return p + std::countr_zero((u64(m1) << 32) | m0);
+    }
+    if (e - p >= 32) {
+        if (u32 m = match32(p, n)) return p + std::countr_zero(m);
+        p += 32;
+    }
+    if (p == e) return e;
+    u32 m = u32(u64(match32(e - 32, n)) >> (32 - (e - p)));
+    return m ? p + std::countr_zero(m) : e;
+}
+
+inline bool cpu_has_avx2() noexcept {
+#ifdef _MSC_VER
+    int r[4];
+    __cpuid(r, 0);
+    if (r[0] < 7) return false;
+    __cpuid(r, 1);
+    // OSXSAVE + AVX, and the OS saves ymm state
+    if ((r[2] & (1 << 27)) == 0 || (r[2] & (1 << 28)) == 0) return false;
+    if ((_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(r, 7, 0);
+    return (r[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+inline bool cpu_has_sse42() noexcept {
+#ifdef _MSC_VER
+    int r[4];
+    __cpuid(r, 1);
+    return (r[2] & (1 << 20)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.2");
+#endif
+}
+#endif
+
+// ascii case folding : flip 0x20 on bytes in [first, first + 25]
+inline void ascii_case_scalar(char* p, size_t n, char first) noexcept {
+    for (size_t i = 0; i < n; ++i)
+        if (u8(p[i] - first) < 26) p[i] ^= 0x20;
+}
+
+inline char ascii_lower(char c) noexcept {
+    return u8(c - 'A') < 26 ? char(c | 0x20) : c;
+}
+
+inline bool ascii_same_nocase_scalar(const char* a, const char* b, size_t n) noexcept {
+    for (size_t i = 0; i < n; ++i)
+        if (ascii_lower(a[i]) != ascii_lower(b[i])) return false;
+    return true;
+}
+
+#ifdef X_SIMD_X86
+inline bool has_avx2() noexcept {
+    static const bool v = cpu_has_avx2();
+    return v;
+}
+
+inline bool has_sse42() noexcept {
+    static const bool v = cpu_has_sse42();
+    return v;
+}
+
+// bytes are signed here, so non-ascii (< 0) never lands in the range
+inline __m128i in_range16(__m128i v, char first) noexcept {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(char(first - 1))),
+                         _mm_cmplt_epi8(v, _mm_set1_epi8(char(first + 26))));
+}
+
+inline void ascii_case_sse2(char* p, size_t n, char first) noexcept {
+    const __m128i bit = _mm_set1_epi8(0x20);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        v = _mm_xor_si128(v, _mm_and_si128(in_range16(v, first), bit));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p + i), v);
+    }
+    ascii_case_scalar(p + i, n - i, first);
+}
+
+inline bool ascii_same_nocase_sse2(const char* a, const char* b, size_t n) noexcept {
+    const __m128i bit = _mm_set1_epi8(0x20);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        auto va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        auto vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        va = _mm_or_si128(va, _mm_and_si128(in_range16(va, 'A'), bit));
+        vb = _mm_or_si128(vb, _mm_and_si128(in_range16(vb, 'A'), bit));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) != 0xFFFF) return false;
+    }
+    return ascii_same_nocase_scalar(a + i, b + i, n - i);
+}
+
+X_TARGET_AVX2
+inline __m256i in_range32(__m256i v, char first) noexcept {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(char(first - 1))),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8(char(first + 26)), v));
+}
+
+X_TARGET_AVX2
+inline void ascii_case_avx2(char* p, size_t n, char first) noexcept {
+    const __m256i bit = _mm256_set1_epi8(0x20);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        v = _mm256_xor_si256(v, _mm256_and_si256(in_range32(v, first), bit));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + i), v);
+    }
+    ascii_case_sse2(p + i, n - i, first);
+}
+
+X_TARGET_AVX2
+inline bool ascii_same_nocase_avx2(const char* a, const char* b, size_t n) noexcept {
+    const __m256i bit = _mm256_set1_epi8(0x20);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        auto va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        auto vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        va = _mm256_or_si256(va, _mm256_and_si256(in_range32(va, 'A'), bit));
+        vb = _mm256_or_si256(vb, _mm256_and_si256(in_range32(vb, 'A'), bit));
+        if (u32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb))) != 0xFFFFFFFF) return false;
+    }
+    return ascii_same_nocase_sse2(a + i, b + i, n - i);
+}
+#endif
+
+// substring search filter : compare first and last needle byte for 16/32
+// candidate positions at once, memcmp only the survivors (needle size >= 2)
+inline size_t find_pair_scalar(cSView& h, cSView& nd, size_t pos) noexcept {
+    return h.find(nd, pos);
+}
+
+#ifdef X_SIMD_X86
+inline size_t find_pair_sse2(cSView& h, cSView& nd, size_t pos) noexcept {
+    const size_t n = nd.size();
+    const __m128i first = _mm_set1_epi8(nd[0]);
+    const __m128i last  = _mm_set1_epi8(nd[n - 1]);
+    size_t i = pos;
+    for (; i + n - 1 + 16 <= h.size(); i += 16) {
+        auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h.data() + i));
+        auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h.data() + i + n - 1));
+        u32  m = u32(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first),
+                                                      _mm_cmpeq_epi8(b, last))));
+        for (; m; m &= m - 1) {
+            size_t at = i + std::countr_zero(m);
+            if (std::memcmp(h.data() + at + 1, nd.data() + 1, n - 2) == 0) return at;
+        }
+    }
+    return h.find(nd, i);
+}
+
+X_TARGET_AVX2
+inline size_t find_pair_avx2(cSView& h, cSView& nd, size_t pos) noexcept {
+    const size_t n = nd.size();
+    const __m256i first = _mm256_set1_epi8(nd[0]);
+    const __m256i last  = _mm256_set1_epi8(nd[n - 1]);
+    size_t i = pos;
+    for (; i + n - 1 + 32 <= h.size(); i += 32) {
+        auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h.data() + i));
+        auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h.data() + i + n - 1));
+        u32  m = u32(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first),
+                                                            _mm256_cmpeq_epi8(b, last))));
+        for (; m; m &= m - 1) {
+            size_t at = i + std::countr_zero(m);
+            if (std::memcmp(h.data() + at + 1, nd.data() + 1, n - 2) == 0) return at;
+        }
+    }
+    return find_pair_sse2(h, nd, i);
+}
+#endif
+
+inline size_t find_pair(cSView& h, cSView& nd, size_t pos) noexcept {
+#ifdef X_SIMD_X86
+    if (has_avx2()) return find_pair_avx2(h, nd, pos);
+    return find_pair_sse2(h, nd, pos);
+#else
+    return find_pair_scalar(h, nd, pos);
+#endif
+}
+
+inline void ascii_case(char* p, size_t n, char first) noexcept {
+#ifdef X_SIMD_X86
+    if (n >= 32 && has_avx2()) return ascii_case_avx2(p, n, first);
+    return ascii_case_sse2(p, n, first);
+#else
+    return ascii_case_scalar(p, n, first);
+#endif
+}
+
+inline bool ascii_same_nocase(const char* a, const char* b, size_t n) noexcept {
+#ifdef X_SIMD_X86
+    if (n >= 32 && has_avx2()) return ascii_same_nocase_avx2(a, b, n);
+    return ascii_same_nocase_sse2(a, b, n);
+#else
+    return ascii_same_nocase_scalar(a, b, n);
+#endif
+}
+
+inline const char* find_byte_resolve(const char* p, const char* e, char c) noexcept;
+
+// starts at the resolver, which swaps in the best kernel on first use
+inline std::atomic<find_byte_fn> find_byte_impl{find_byte_resolve};
+
+inline const char* find_byte_resolve(const char* p, const char* e, char c) noexcept {
+#ifdef X_SIMD_X86
+    find_byte_fn fn = cpu_has_avx2() ? find_byte_avx2 : find_byte_sse2;
+#else
+    find_byte_fn fn = find_byte_scalar;
+#endif
+    find_byte_impl.store(fn, std::memory_order_relaxed);
+    return fn(p, e, c);
+}
+
+} // namespace detail
+
+// position of the first c in s at or after pos, npos if none
+inline size_t find_byte(cSView& s, char c, size_t pos = 0) noexcept {
+    if (pos >= s.size()) return sView::npos;
+    const char* e = s.data() + s.size();
+    const char* r = detail::find_byte_impl.load(std::memory_order_relaxed)(s.data() + pos, e, c);
+    return r == e ? sView::npos : size_t(r - s.data());
+}
+
+namespace detail {
+// single-byte patterns go through the simd scan
+inline size_t find_fast(cSView& s, cSView& sub, size_t pos = 0) noexcept {
+    if (sub.size() == 1) return find_byte(s, sub[0], pos);
+    return s.find(sub, pos);
 }
+} // namespace detail
 
 // ----------------------- string operations -----------------------
 inline _vec<str> split(cStr &s, cSView& delimiter) noexcept {
     if(s.empty() || delimiter.empty()) return {};
     _vec<str> result;
     size_t start = 0;
-    size_t end = s.find(delimiter);
+    size_t end = detail::find_fast(s, delimiter);
     while (end != str::npos) {
         result.emplace_back(s.substr(start, end - start));
         start = end + delimiter.length();
-        end = s.find(delimiter, start);
+        end = detail::find_fast(s, delimiter, start);
     }
     if (start == 0) return {};
     result.emplace_back(s.substr(start));
     return result;
 }
 
-template<typename Range>
-inline str join(const Range& parts, cSView& delimiter) noexcept {
-    if (parts.empty()) return "";
-    str result;
-    auto it = parts.begin();
-    result += *it;
-    ++it;
-    for (; it != parts.end(); ++it) {
-        result += delimiter;
-        result += *it;
+// same as split, but the fields view into s (s must outlive the result)
+inline _vec<sView> split_view(cSView& s, cSView& delimiter) noexcept {
+    if(s.empty() || delimiter.empty()) return {};
+    _vec<sView> result;
+    size_t start = 0;
+    size_t end = detail::find_fast(s, delimiter);
+    while (end != sView::npos) {
+        result.emplace_back(s.substr(start, end - start));
+        start = end + delimiter.length();
+        end = detail::find_fast(s, delimiter, start);
     }
+    if (start == 0) return {};
+    result.emplace_back(s.substr(start));
     return result;
 }
 
-inline str trim(cStr &s) noexcept {
-    auto start = std::find_if_not(s.begin(), s.end(), ::isspace);
-    auto end = std::find_if_not(s.rbegin(), s.rend(), ::isspace).base();
-    return {start, end};
+// lazy split : yields sView fields on demand, no allocation
+// for (auto field : x::splitter(line, ",")) {...}
+class Splitter : public std::ranges::view_interface<Splitter> {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = sView;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const sView*;
+        using reference         = sView;
+
+        iterator() = default;
+        iterator(cSView& s, cSView& delimiter) noexcept
+            : s_(s), delim_(delimiter), done_(false) {
+            next_ = detail::find_fast(s_, delim_);
+        }
+
+        sView operator*() const noexcept {
+            return next_ == sView::npos ? s_.substr(start_)
+                                        : s_.substr(start_, next_ - start_);
+        }
+
+        iterator& operator++() noexcept {
+            if (next_ == sView::npos) {
+                done_ = true;
+                start_ = s_.size();
+                return *this;
+            }
+            start_ = next_ + delim_.size();
+            next_  = detail::find_fast(s_, delim_, start_);
+            return *this;
+        }
+
+        iterator operator++(int) noexcept {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const iterator& other) const noexcept {
+            return done_ == other.done_ && (done_ || start_ == other.start_);
+        }
+
+    private:
+        sView  s_;
+        sView  delim_;
+        size_t start_ = 0;
+        size_t next_  = sView::npos;
+        bool   done_  = true;
+    };
+
+    Splitter() = default;
+    Splitter(cSView& s, cSView& delimiter) noexcept
+        : s_(s), delim_(delimiter) {}
+
+    iterator begin() const noexcept {
+        // keep split semantics : no delimiter found -> empty
+        if (s_.empty() || delim_.empty() || detail::find_fast(s_, delim_) == sView::npos)
+            return {};
+        return iterator(s_, delim_);
+    }
+
+    iterator end() const noexcept { return {}; }
+
+private:
+    sView s_;
+    sView delim_;
+};
+
+inline Splitter splitter(cSView& s, cSView& delimiter) noexcept {
+    return Splitter(s, delimiter);
 }
 
-inline str replace(str s, cSView& old_sub, cSView& new_sub) noexcept {
-    size_t pos = 0;
-    while ((pos = s.find(old_sub, pos)) != str::npos) {
-        s.replace(pos, old_sub.length(), new_sub);
-        pos += new_sub.length();
+namespace detail {
+template<typename T>
+concept string_like = std::is_convertible_v<const T&, sView>;
+
+template<typename Range, typename Proj>
+using join_elem_t = std::remove_cvref_t<
+    std::invoke_result_t<Proj&, std::ranges::range_reference_t<Range>>>;
+
+template<typename OutputIt, typename T>
+inline OutputIt write_elem(OutputIt out, const T& v) {
+    if constexpr (string_like<T>) {
+        sView sv = v;
+        return std::copy(sv.begin(), sv.end(), out);
+    } else {
+        return std::format_to(out, "{}", v);
     }
-    return s;
 }
+} // namespace detail
 
-inline str reverse(str s) noexcept {
-    std::reverse(s.begin(), s.end());
-    return s;
+// exact joined length, for string-like elements (after projection)
+template<std::ranges::forward_range Range, typename Proj = std::identity>
+requires detail::string_like<detail::join_elem_t<Range, Proj>>
+inline size_t join_size(Range&& parts, cSView& delimiter, Proj proj = {}) {
+    size_t n = 0, size = 0;
+    for (auto&& p : parts) {
+        size += sView(std::invoke(proj, p)).size();
+        ++n;
+    }
+    return n ? size + (n - 1) * delimiter.size() : 0;
 }
 
-inline str upper(str s) noexcept {
-    std::transform(s.begin(), s.end(), s.begin(), ::toupper);
-    return s;
+// write the joined parts to out, returns the end of the output
+// char buf[256]; auto e = x::join_to(buf, fields, ",");
+template<typename OutputIt, std::ranges::input_range Range, typename Proj = std::identity>
+inline OutputIt join_to(OutputIt out, Range&& parts, cSView& delimiter, Proj proj = {}) {
+    bool first = true;
+    for (auto&& p : parts) {
+        if (!first) out = std::copy(delimiter.begin(), delimiter.end(), out);
+        first = false;
+        out = detail::write_elem(out, std::invoke(proj, p));
+    }
+    return out;
 }
 
-inline str lower(str s) noexcept {
-    std::transform(s.begin(), s.end(), s.begin(), ::tolower);
-    return s;
+// string-like elements are sized first and appended into one allocation,
+// anything else goes through std::format ("{}")
+// x::join(users, ", ", &User::name);  x::join(ids, ",");
+template<std::ranges::input_range Range, typename Proj = std::identity>
+inline str join(Range&& parts, cSView& delimiter, Proj proj = {}) {
+    using E = detail::join_elem_t<Range, Proj>;
+    str result;
+    if constexpr (detail::string_like<E> && std::ranges::forward_range<Range>) {
+        result.reserve(join_size(parts, delimiter, proj));
+        bool first = true;
+        for (auto&& p : parts) {
+            if (!first) result += delimiter;
+            first = false;
+            result += sView(std::invoke(proj, p));
+        }
+    } else {
+        join_to(std::back_inserter(result), parts, delimiter, proj);
+    }
+    return result;
 }
 
-inline bool startWith(cStr& s, cSView& prefix) noexcept {
-    return s.substr(0, prefix.size()) == prefix;
+namespace detail {
+// same set as ::isspace in the C locale
+inline bool is_space(char c) noexcept {
+    return c == ' ' || (c >= '\t' && c <= '\r');
 }
 
-inline bool endWith(cStr& s, cSView& suffix) noexcept {
-    return s.size() >= suffix.size() && 
-    s.substr(s.size() - suffix.size()) == suffix;
+// range size parallel_for splits [0, n) into (n : serial)
+inline size_t pool_chunk(size_t n, size_t min_chunk, u32 threads) noexcept {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t workers = std::min<size_t>(threads, n / std::max<size_t>(min_chunk, 1));
+    return workers <= 1 ? n : (n + workers - 1) / workers;
 }
 
-inline bool contain(cSView& sv, cSView& sub) noexcept {
-    return sv.find(sub) != sView::npos;
+// times parallel_for runs fn, so workers can meet at a std::barrier
+inline size_t pool_workers(size_t n, size_t min_chunk, u32 threads) noexcept {
+    size_t chunk = pool_chunk(n, min_chunk, threads);
+    return chunk == 0 ? 1 : (n + chunk - 1) / chunk;
 }
 
-inline bool is_digit(cStr& ss) noexcept {
-    if (ss.empty()) return false;
-    auto s = ss;
-    bool is_negative = false;
-    if (s[0] == '-') {
-        is_negative = true;
-        s.erase(0, 1); // remove negative sign
-    }
-    bool has_decimal_point = false;
-    try {
-        for (char c : s) {
-            if (c == '.') {
-                if (has_decimal_point) return false;
-                has_decimal_point = true;
-            } else if (c <= -1 || !std::isdigit(c)) {
-                return false; 
-            }
-        }
-    } catch (...) {
-        return false;
+// run fn(begin, end) over [0, n) split across up to threads workers,
+// serially when n is below min_chunk * 2
+template<typename F>
+inline void parallel_for(size_t n, size_t min_chunk, F&& fn, u32 threads = 0) {
+    size_t chunk = pool_chunk(n, min_chunk, threads);
+    if (chunk >= n) {
+        fn(size_t(0), n);
+        return;
     }
-    return true;
+    size_t workers = (n + chunk - 1) / chunk;
+    _vec<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (size_t b = chunk; b < n; b += chunk)
+        pool.emplace_back([&fn, b, e = std::min(n, b + chunk)] { fn(b, e); });
+    fn(size_t(0), std::min(n, chunk));
+    for (auto& t : pool) t.join();
 }
+} // namespace detail
 
-inline bool same_nocase(cStr& s1, cStr& s2) noexcept {
-    if (s1.size() != s2.size()) return false;
-    return std::equal(s1.begin(), s1.end(), s2.begin(), 
-                      [](char a, char b) { return ::tolower(a) == ::tolower(b); });
+inline sView ltrim(cSView& s) noexcept {
+    size_t b = 0;
+    while (b < s.size() && detail::is_space(s[b])) ++b;
+    return s.substr(b);
 }
 
-// ----------------------- filesystem operations -----------------------
-inline str file_name(cStr &path){
-    return std::filesystem::path(path).filename().string();
+inline sView rtrim(cSView& s) noexcept {
+    size_t e = s.size();
+    while (e > 0 && detail::is_space(s[e - 1])) --e;
+    return s.substr(0, e);
 }
 
-inline str file_extension(cStr& filename) noexcept{
-    size_t last_dot = filename.find_last_of('.');
-    if (last_dot == str::npos) {
-        return "";
-    }
-    return filename.substr(last_dot + 1);
+// trimmed view into s, no allocation
+inline sView trim_view(cSView& s) noexcept {
+    return rtrim(ltrim(s));
 }
 
-inline bool exists(cStr& path) noexcept {
-    return std::filesystem::exists(path);
+inline void trim_inplace(str& s) noexcept {
+    sView v = trim_view(s);
+    if (v.size() == s.size()) return;
+    size_t b = size_t(v.data() - s.data());
+    s.erase(b + v.size());
+    s.erase(0, b);
 }
 
-inline bool is_file(cStr& path) noexcept {
-    return std::filesystem::is_regular_file(path);
+inline str trim(cSView& s) noexcept {
+    return str(trim_view(s));
+}
+
+// trim every view in place, split across threads for large batches
+inline void trim_all(std::span<sView> views, u32 threads = 0) {
+    detail::parallel_for(views.size(), 1 << 14, [views](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i)
+            views[i] = trim_view(views[i]);
+    }, threads);
+}
+
+inline str replace(str s, cSView& old_sub, cSView& new_sub) noexcept {
+    if (old_sub.empty()) {
+        // like python : new_sub around every char
+        str result;
+        result.reserve(s.size() + (s.size() + 1) * new_sub.size());
+        result += new_sub;
+        for (char c : s) {
+            result += c;
+            result += new_sub;
+        }
+        return result;
+    }
+    size_t pos = detail::find_fast(s, old_sub);
+    if (pos == str::npos) return s;
+    // copy the gaps into a new string instead of shifting the tail in place
+    str result;
+    result.reserve(s.size());
+    size_t last = 0;
+    for (; pos != str::npos; pos = detail::find_fast(s, old_sub, last)) {
+        result.append(s, last, pos - last);
+        result += new_sub;
+        last = pos + old_sub.size();
+    }
+    result.append(s, last);
+    return result;
 }
 
-inline bool is_dir(cStr& path) noexcept {
-    return std::filesystem::is_directory(path);
-}
+// compiled {pattern -> replacement} set for replace_many (Aho-Corasick)
+// matches are leftmost-longest and never overlap, replaced text is not rescanned
+// build once, reuse across calls : x::ReplaceSet rs{{"<", "&lt;"}, {">", "&gt;"}};
+class ReplaceSet {
+public:
+    ReplaceSet() = default;
+    ReplaceSet(std::initializer_list<std::pair<sView, sView>> pairs) {
+        for (const auto& [from, to] : pairs)
+            add(from, to);
+        build();
+    }
+
+    // empty patterns are ignored, a repeated pattern keeps the last replacement
+    ReplaceSet& add(cSView& pattern, cSView& replacement) {
+        if (pattern.empty()) return *this;
+        for (auto& [from, to] : pairs_) {
+            if (from == pattern) {
+                to = replacement;
+                built_ = false;
+                return *this;
+            }
+        }
+        pairs_.emplace_back(pattern, replacement);
+        built_ = false;
+        return *this;
+    }
+
+    // compile the automaton, required after the last add
+    void build() {
+        class_.fill(0);
+        nclass_ = 1;
+        for (const auto& [from, to] : pairs_)
+            for (u8 c : from)
+                if (!class_[c]) class_[c] = u16(nclass_++);
+
+        constexpr u32 none = 0xFFFFFFFF;
+        delta_.assign(nclass_, none);
+        out_.assign(1, none);
+        depth_.assign(1, 0);
+        for (u32 i = 0; i < pairs_.size(); ++i) {
+            u32 st = 0;
+            for (u8 c : pairs_[i].first) {
+                u32& next = delta_[st * nclass_ + class_[c]];
+                if (next == none) {
+                    next = u32(out_.size());
+                    delta_.resize(delta_.size() + nclass_, none);
+                    out_.push_back(none);
+                    depth_.push_back(depth_[st] + 1);
+                }
+                st = delta_[st * nclass_ + class_[c]];
+            }
+            out_[st] = i;
+        }
+
+        // bfs : fail links, then fill missing edges to get a full dfa
+        const u32 nstate = u32(out_.size());
+        _vec<u32> fail(nstate, 0), queue;
+        dict_.assign(nstate, none);
+        queue.reserve(nstate);
+        for (u32 c = 0; c < nclass_; ++c) {
+            u32& next = delta_[c];
+            if (next == none) next = 0;
+            else queue.push_back(next);
+        }
+        for (size_t qi = 0; qi < queue.size(); ++qi) {
+            u32 st = queue[qi];
+            u32 f  = fail[st];
+            dict_[st] = out_[f] != none ? f : dict_[f];
+            for (u32 c = 0; c < nclass_; ++c) {
+                u32& next = delta_[st * nclass_ + c];
+                if (next == none) {
+                    next = delta_[f * nclass_ + c];
+                } else {
+                    fail[next] = delta_[f * nclass_ + c];
+                    queue.push_back(next);
+                }
+            }
+        }
+        built_ = true;
+    }
+
+    str apply(cSView& s) const {
+        if (pairs_.empty()) return str(s);
+        if (!built_)
+            throw std::runtime_error("ReplaceSet: build() not called after add()");
+
+        // leftmost-longest during the scan : best is the leftmost (then longest)
+        // match seen since the last kept one. once the automaton's live suffix
+        // starts past it no later match can beat it, so it is kept and the scan
+        // resumes at its end. only kept (start, pattern) pairs are stored
+        constexpr u32    none = 0xFFFFFFFF;
+        constexpr size_t npos = size_t(-1);
+        _vec<std::pair<size_t, u32>> hits;
+        size_t out_size = s.size(), best = npos;
+        u32    best_id  = 0, st = 0;
+        for (size_t i = 0;;) {
+            if (best != npos && (i == s.size() || i - depth_[st] > best)) {
+                const auto& [from, to] = pairs_[best_id];
+                hits.emplace_back(best, best_id);
+                out_size = out_size - from.size() + to.size();
+                i    = best + from.size();
+                st   = 0;
+                best = npos;
+                continue;
+            }
+            if (i == s.size()) break;
+            st = delta_[st * nclass_ + class_[u8(s[i++])]];
+            // the first state on the dict chain is the longest match ending here
+            u32 m = out_[st] != none ? st : dict_[st];
+            if (m != none && (best == npos || i - depth_[m] <= best)) {
+                best    = i - depth_[m];
+                best_id = out_[m];
+            }
+        }
+        if (hits.empty()) return str(s);
+
+        str result;
+        result.reserve(out_size);
+        size_t last = 0;
+        for (const auto& [pos, id] : hits) {
+            const auto& [from, to] = pairs_[id];
+            result.append(s, last, pos - last);
+            result += to;
+            last = pos + from.size();
+        }
+        result.append(s, last);
+        return result;
+    }
+
+    size_t size()  const noexcept { return pairs_.size();  }
+    bool   empty() const noexcept { return pairs_.empty(); }
+
+private:
+    _vec<std::pair<str, str>>   pairs_;
+    std::array<u16, 256>        class_{};   // byte -> column, 0 = not in any pattern
+    u32                         nclass_ = 1;
+    _vec<u32>                   delta_;     // state * nclass_ + column -> state
+    _vec<u32>                   out_;       // pattern ending at state, or none
+    _vec<u32>                   dict_;      // next matching state on the fail chain
+    _vec<u32>                   depth_;
+    bool                        built_ = false;
+};
+
+// rewrite s in one pass for every pair in the set
+inline str replace_many(cSView& s, const ReplaceSet& set) {
+    return set.apply(s);
+}
+
+inline str replace_many(cSView& s, std::initializer_list<std::pair<sView, sView>> pairs) {
+    return ReplaceSet(pairs).apply(s);
+}
+
+inline str reverse(str s) noexcept {
+    std::reverse(s.begin(), s.end());
+    return s;
+}
+
+// ascii only, other bytes are kept as is
+inline void upper_inplace(str& s) noexcept {
+    detail::ascii_case(s.data(), s.size(), 'a');
+}
+
+inline void lower_inplace(str& s) noexcept {
+    detail::ascii_case(s.data(), s.size(), 'A');
+}
+
+inline str upper(str s) noexcept {
+    upper_inplace(s);
+    return s;
+}
+
+inline str lower(str s) noexcept {
+    lower_inplace(s);
+    return s;
+}
+
+// locale aware, only when asked for : x::upper(s, std::locale("de_DE.UTF-8"))
+inline str upper(str s, const std::locale& loc) {
+    std::use_facet<std::ctype<char>>(loc).toupper(s.data(), s.data() + s.size());
+    return s;
+}
+
+inline str lower(str s, const std::locale& loc) {
+    std::use_facet<std::ctype<char>>(loc).tolower(s.data(), s.data() + s.size());
+    return s;
+}
+
+inline bool startWith(cSView& s, cSView& prefix) noexcept {
+    return s.starts_with(prefix);
+}
+
+inline bool endWith(cSView& s, cSView& suffix) noexcept {
+    return s.ends_with(suffix);
+}
+
+inline bool contain(cSView& sv, cSView& sub) noexcept {
+    return detail::find_fast(sv, sub) != sView::npos;
+}
+
+// ----------------------- Pattern -----------------------
+// needle preprocessed once for repeated searches :
+//   1 byte     -> simd byte scan
+//   2..32      -> simd first/last byte filter
+//   longer     -> Boyer-Moore-Horspool
+// x::Pattern err("ERROR"); for (auto line : lines) if (err.contains(line)) ...
+class Pattern {
+public:
+    Pattern() = default;
+    explicit Pattern(cSView& needle) : needle_(needle) {
+        if (needle_.size() > 32) {
+            skip_ = std::make_unique<std::array<u32, 256>>();
+            skip_->fill(u32(needle_.size()));
+            for (size_t i = 0; i + 1 < needle_.size(); ++i)
+                (*skip_)[u8(needle_[i])] = u32(needle_.size() - 1 - i);
+        }
+    }
+
+    Pattern(const Pattern& other) : Pattern(sView(other.needle_)) {}
+    Pattern(Pattern&&) noexcept = default;
+    Pattern& operator=(const Pattern& other) {
+        if (this != &other) *this = Pattern(sView(other.needle_));
+        return *this;
+    }
+    Pattern& operator=(Pattern&&) noexcept = default;
+
+    // first match at or after pos, npos if none
+    size_t find(cSView& s, size_t pos = 0) const noexcept {
+        const size_t n = needle_.size();
+        if (n == 0) return pos <= s.size() ? pos : sView::npos;
+        if (pos > s.size() || s.size() - pos < n) return sView::npos;
+        if (n == 1) return find_byte(s, needle_[0], pos);
+        if (!skip_) return detail::find_pair(s, needle_, pos);
+        // horspool : shift by the skip of the byte under the needle's last slot
+        const char last = needle_[n - 1];
+        for (size_t i = pos; i + n <= s.size(); i += (*skip_)[u8(s[i + n - 1])]) {
+            if (s[i + n - 1] == last && std::memcmp(s.data() + i, needle_.data(), n - 1) == 0)
+                return i;
+        }
+        return sView::npos;
+    }
+
+    bool contains(cSView& s) const noexcept {
+        return find(s) != sView::npos;
+    }
+
+    // non-overlapping, an empty needle counts nothing
+    size_t count(cSView& s) const noexcept {
+        if (needle_.empty()) return 0;
+        size_t n = 0;
+        for (size_t p = find(s); p != sView::npos; p = find(s, p + needle_.size()))
+            ++n;
+        return n;
+    }
+
+    _vec<size_t> find_all(cSView& s) const {
+        _vec<size_t> result;
+        if (needle_.empty()) return result;
+        for (size_t p = find(s); p != sView::npos; p = find(s, p + needle_.size()))
+            result.push_back(p);
+        return result;
+    }
+
+    cStr&  needle() const noexcept { return needle_;        }
+    size_t size()   const noexcept { return needle_.size(); }
+
+private:
+    str                                       needle_;
+    std::unique_ptr<std::array<u32, 256>>     skip_;
+};
+
+inline bool contain(cSView& sv, const Pattern& p) noexcept {
+    return p.contains(sv);
+}
+
+inline bool is_digit(cSView& ss) noexcept {
+    if (ss.empty()) return false;
+    auto s = ss[0] == '-' ? ss.substr(1) : ss; // skip negative sign
+    bool has_decimal_point = false;
+    for (char c : s) {
+        if (c == '.') {
+            if (has_decimal_point) return false;
+            has_decimal_point = true;
+        } else if (c < '0' || c > '9') {
+            return false; 
+        }
+    }
+    return true;
+}
+
+// parse the whole of s as a number, no allocation / exception
+// if (auto v = x::parse<i32>(field)) use(*v);
+template<typename T>
+requires (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+inline std::optional<T> parse(cSView& s) noexcept {
+    const char* b = s.data();
+    const char* e = s.data() + s.size();
+    if (b != e && *b == '+') {      // from_chars rejects a leading '+'
+        ++b;
+        if (b != e && *b == '-') return std::nullopt;
+    }
+    if (b == e) return std::nullopt;
+    T v{};
+    auto [p, ec] = std::from_chars(b, e, v);
+    if (ec != std::errc() || p != e) return std::nullopt;
+    return v;
+}
+
+// batch parse a column into out (out.size() >= col.size())
+// fields that fail to parse get fallback, returns the number parsed ok
+template<typename T>
+requires (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+inline size_t parse_to(std::span<const sView> col, std::span<T> out, T fallback = T{}) noexcept {
+    size_t ok = 0, n = std::min(col.size(), out.size());
+    for (size_t i = 0; i < n; ++i) {
+        auto v = parse<T>(col[i]);
+        ok += v.has_value();
+        out[i] = v ? *v : fallback;
+    }
+    return ok;
+}
+
+template<typename T>
+requires (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+inline _vec<T> parse_column(std::span<const sView> col, T fallback = T{}) {
+    _vec<T> out(col.size());
+    parse_to<T>(col, out, fallback);
+    return out;
+}
+
+// ascii case-insensitive compare
+inline bool same_nocase(cSView& s1, cSView& s2) noexcept {
+    if (s1.size() != s2.size()) return false;
+    return detail::ascii_same_nocase(s1.data(), s2.data(), s1.size());
+}
+
+inline bool same_nocase(cSView& s1, cSView& s2, const std::locale& loc) {
+    if (s1.size() != s2.size()) return false;
+    auto& ct = std::use_facet<std::ctype<char>>(loc);
+    return std::equal(s1.begin(), s1.end(), s2.begin(), 
+                      [&ct](char a, char b) { return ct.tolower(a) == ct.tolower(b); });
+}
+
+// ----------------------- StrBuf -----------------------
+// string builder with N bytes inline, spills to the heap only on overflow
+// x::StrBuf b; b.append("id=").append_int(42).append_fmt(" t={:.2f}", 1.5);
+// _prtln("{}", b);  x::write_file(path, b);
+template<size_t N = 256>
+class StrBuf {
+public:
+    using value_type = char;
+
+    StrBuf() noexcept = default;
+    StrBuf(cSView& s) { append(s); }
+    ~StrBuf() { release(); }
+
+    StrBuf(const StrBuf& other) { append(other.view()); }
+
+    StrBuf(StrBuf&& other) noexcept { take(other); }
+
+    StrBuf& operator=(const StrBuf& other) {
+        if (this != &other) {
+            size_ = 0;
+            append(other.view());
+        }
+        return *this;
+    }
+
+    StrBuf& operator=(StrBuf&& other) noexcept {
+        if (this != &other) {
+            release();
+            take(other);
+        }
+        return *this;
+    }
+
+    StrBuf& append(cSView& s) {
+        if (size_ + s.size() > cap_ && s.data() >= data_ && s.data() < data_ + size_)
+            return append(str(s)); // s points into this buffer, which is about to move
+        reserve(size_ + s.size());
+        std::memcpy(data_ + size_, s.data(), s.size());
+        size_ += s.size();
+        return *this;
+    }
+
+    StrBuf& append(char c) {
+        push_back(c);
+        return *this;
+    }
+
+    // formats straight into the free space, grows and retries only if it does not fit
+    template<typename... Args>
+    StrBuf& append_fmt(std::format_string<Args...> ft, Args&&... args) {
+        size_t room = cap_ - size_;
+        auto r = std::format_to_n(data_ + size_, std::ptrdiff_t(room), ft, std::forward<Args>(args)...);
+        size_t n = size_t(r.size);
+        if (n > room) {
+            reserve(size_ + n);
+            std::format_to_n(data_ + size_, std::ptrdiff_t(n), ft, std::forward<Args>(args)...);
+        }
+        size_ += n;
+        return *this;
+    }
+
+    template<typename T>
+    requires (std::is_integral_v<T> && !std::is_same_v<T, bool>)
+    StrBuf& append_int(T v) {
+        reserve(size_ + 24);
+        size_ = size_t(std::to_chars(data_ + size_, data_ + cap_, v).ptr - data_);
+        return *this;
+    }
+
+    // shortest round-trip form, or fixed with precision digits
+    template<typename T>
+    requires std::is_floating_point_v<T>
+    StrBuf& append_float(T v, i32 precision = -1) {
+        for (size_t room = 32;; room *= 4) {
+            reserve(size_ + room);
+            auto r = precision < 0
+                   ? std::to_chars(data_ + size_, data_ + cap_, v)
+                   : std::to_chars(data_ + size_, data_ + cap_, v, std::chars_format::fixed, precision);
+            if (r.ec == std::errc()) {
+                size_ = size_t(r.ptr - data_);
+                return *this;
+            }
+        }
+    }
+
+    StrBuf& operator+=(cSView& s) { return append(s); }
+    StrBuf& operator+=(char c)    { return append(c);  }
+
+    void push_back(char c) {
+        if (size_ == cap_) reserve(size_ + 1);
+        data_[size_++] = c;
+    }
+
+    void reserve(size_t n) {
+        if (n <= cap_) return;
+        size_t cap = std::max(n, cap_ * 2);
+        char*  buf = new char[cap];
+        std::memcpy(buf, data_, size_);
+        release();
+        data_ = buf;
+        cap_  = cap;
+    }
+
+    void clear() noexcept { size_ = 0; }
+
+    sView       view()     const noexcept { return {data_, size_};      }
+    str         to_str()   const          { return str(data_, size_);   }
+    const char* data()     const noexcept { return data_;               }
+    size_t      size()     const noexcept { return size_;               }
+    size_t      capacity() const noexcept { return cap_;                }
+    bool        empty()    const noexcept { return size_ == 0;          }
+    bool        on_heap()  const noexcept { return data_ != inline_;    }
+
+    operator sView()       const noexcept { return view();              }
+
+private:
+    void release() noexcept {
+        if (on_heap()) delete[] data_;
+        data_ = inline_;
+        cap_  = N;
+    }
+
+    void take(StrBuf& other) noexcept {
+        if (other.on_heap()) {
+            data_ = other.data_;
+            cap_  = other.cap_;
+        } else {
+            std::memcpy(inline_, other.inline_, other.size_);
+        }
+        size_ = other.size_;
+        other.data_ = other.inline_;
+        other.cap_  = N;
+        other.size_ = 0;
+    }
+
+    char*  data_ = inline_;
+    size_t size_ = 0;
+    size_t cap_  = N;
+    char   inline_[N];
+};
+
+// ----------------------- fmt_to -----------------------
+// checked at compile time, writes into caller storage
+// char b[64]; sView v = x::fmt_to(b, "id={} t={:.2f}", id, t);   // truncates to 64
+// x::fmt_to(strbuf, "...", ...); x::fmt_to(s, "...", ...);        // append
+// auto b = x::fmt_buf("{}:{}", host, port);                       // StrBuf<256>
+template<typename... Args>
+inline sView fmt_to(std::span<char> buf, std::format_string<Args...> ft, Args&&... args) {
+    auto r = std::format_to_n(buf.data(), std::ptrdiff_t(buf.size()), ft, std::forward<Args>(args)...);
+    return {buf.data(), std::min(size_t(r.size), buf.size())};
+}
+
+template<size_t N, typename... Args>
+inline StrBuf<N>& fmt_to(StrBuf<N>& buf, std::format_string<Args...> ft, Args&&... args) {
+    return buf.append_fmt(ft, std::forward<Args>(args)...);
+}
+
+template<typename... Args>
+inline str& fmt_to(str& out, std::format_string<Args...> ft, Args&&... args) {
+    std::format_to(std::back_inserter(out), ft, std::forward<Args>(args)...);
+    return out;
+}
+
+template<size_t N = 256, typename... Args>
+inline StrBuf<N> fmt_buf(std::format_string<Args...> ft, Args&&... args) {
+    StrBuf<N> b;
+    b.append_fmt(ft, std::forward<Args>(args)...);
+    return b;
+}
+
+// length the output would have, without writing it
+template<typename... Args>
+inline size_t fmt_size(std::format_string<Args...> ft, Args&&... args) {
+    return std::formatted_size(ft, std::forward<Args>(args)...);
+}
+
+// runtime format string parsed once : plain "{}" fields of strings / numbers
+// are written directly, literal runs are copied, and stretches holding
+// fields with a spec go to vformat as one re-numbered piece
+// x::Format f(cfg["line"]);  f.format_to(buf, name, qty);
+// throws std::format_error on malformed braces
+class Format {
+public:
+    Format() = default;
+    explicit Format(cSView& ft) { parse(ft); }
+
+    template<typename... Args>
+    str format(Args&&... args) const {
+        str out;
+        out.reserve(literal_size_ + 16 * fields_);
+        format_to(out, args...);
+        return out;
+    }
+
+    template<typename Out, typename... Args>
+    requires requires(Out& o, sView v) { o.append(v); }
+    Out& format_to(Out& out, Args&&... args) const {
+        if (fields_ && max_arg_ >= sizeof...(Args))
+            throw std::format_error("x::Format: argument index out of range");
+        for (const auto& p : pieces_) {
+            sView t = sView(text_).substr(p.off, p.len);
+            switch (p.kind) {
+            case Kind::Literal:
+                out.append(t);
+                break;
+            case Kind::Plain: {
+                u32 k = 0;
+                ((k++ == p.arg ? put(out, args) : void()), ...);
+                break;
+            }
+            case Kind::Spec:
+                vwrite(out, t, std::make_format_args(args...));
+                break;
+            }
+        }
+        return out;
+    }
+
+    sView  text()   const noexcept { return sView(text_).substr(0, source_size_); }
+    size_t fields() const noexcept { return fields_; }
+
+private:
+    enum class Kind : u8 { Literal, Plain, Spec };
+
+    struct Piece {
+        Kind kind;
+        u32  off;
+        u32  len;
+        u32  arg = 0;
+    };
+
+    template<typename Out>
+    static void vwrite(Out& out, sView ft, std::format_args fa) {
+        if constexpr (std::is_same_v<Out, str>) {
+            std::vformat_to(std::back_inserter(out), ft, fa);
+        } else {
+            thread_local str tmp;
+            tmp.clear();
+            std::vformat_to(std::back_inserter(tmp), ft, fa);
+            out.append(sView(tmp));
+        }
+    }
+
+    template<typename Out, typename T>
+    static void put(Out& out, T& v) {
+        using D = std::remove_cvref_t<T>;
+        if constexpr (detail::string_like<D>) {
+            out.append(sView(v));
+        } else if constexpr (std::is_arithmetic_v<D> && !std::is_same_v<D, bool> && !std::is_same_v<D, char>) {
+            // "{}" is defined as the shortest to_chars form
+            char buf[64];
+            auto r = std::to_chars(buf, buf + sizeof(buf), v);
+            out.append(sView(buf, size_t(r.ptr - buf)));
+        } else {
+            vwrite(out, "{}", std::make_format_args(v));
+        }
+    }
+
+    // text_ = source, then the literal runs and vformat pieces built from it
+    void parse(sView ft) {
+        text_.assign(ft);
+        source_size_ = ft.size();
+        str    raw;                 // pending run, braces escaped, fields numbered
+        str    lit;                 // same run, unescaped
+        bool   spec_in_run = false;
+        i32    next = 0;            // automatic numbering
+        bool   manual = false;
+        auto flush = [&] {
+            if (spec_in_run)     add_piece(Kind::Spec, raw);
+            else if (!lit.empty()) add_piece(Kind::Literal, lit);
+            literal_size_ += lit.size();
+            raw.clear();
+            lit.clear();
+            spec_in_run = false;
+        };
+        for (size_t i = 0; i < ft.size(); ++i) {
+            char c = ft[i];
+            if (c == '{' || c == '}') {
+                if (i + 1 < ft.size() && ft[i + 1] == c) {
+                    raw.append(2, c);
+                    lit += c;
+                    ++i;
+                    continue;
+                }
+                if (c == '}')
+                    throw std::format_error("x::Format: unmatched '}'");
+            } else {
+                raw += c;
+                lit += c;
+                continue;
+            }
+            size_t end = ft.find('}', i + 1);
+            if (end == sView::npos)
+                throw std::format_error("x::Format: unmatched '{'");
+            sView field = ft.substr(i + 1, end - i - 1);
+            if (field.find('{') != sView::npos) {
+                // nested width / precision : leave the whole string to vformat
+                pieces_.clear();
+                literal_size_ = 0;
+                text_.resize(source_size_);
+                pieces_.push_back({Kind::Spec, 0, u32(source_size_)});
+                max_arg_ = fields_ = 0;
+                return;
+            }
+            size_t colon = field.find(':');
+            sView  id    = field.substr(0, colon);
+            i32    arg   = 0;
+            if (id.empty()) {
+                if (manual) throw std::format_error("x::Format: mixed automatic and manual indexing");
+                arg = next++;
+            } else {
+                if (next) throw std::format_error("x::Format: mixed automatic and manual indexing");
+                auto r = std::from_chars(id.data(), id.data() + id.size(), arg);
+                if (r.ec != std::errc() || r.ptr != id.data() + id.size() || arg < 0)
+                    throw std::format_error("x::Format: bad argument index");
+                manual = true;
+            }
+            max_arg_ = std::max(max_arg_, size_t(arg));
+            ++fields_;
+            i = end;
+            if (colon == sView::npos) {
+                flush();
+                pieces_.push_back({Kind::Plain, 0, 0, u32(arg)});
+                continue;
+            }
+            raw += '{';
+            raw += std::to_string(arg);
+            raw += field.substr(colon);
+            raw += '}';
+            spec_in_run = true;
+        }
+        flush();
+    }
+
+    void add_piece(Kind k, cSView& t) {
+        pieces_.push_back({k, u32(text_.size()), u32(t.size())});
+        text_ += t;
+    }
+
+    str          text_;
+    _vec<Piece>  pieces_;
+    size_t       source_size_  = 0;
+    size_t       fields_       = 0;
+    size_t       max_arg_      = 0;
+    size_t       literal_size_ = 0;
+};
+
+// ----------------------- filesystem operations -----------------------
+inline str file_name(cStr &path){
+    return std::filesystem::path(path).filename().string();
+}
+
+inline str file_extension(cStr& filename) noexcept{
+    size_t last_dot = filename.find_last_of('.');
+    if (last_dot == str::npos) {
+        return "";
+    }
+    return filename.substr(last_dot + 1);
+}
+
+// ----------------------- stat -----------------------
+enum class FileType : u8 { None, File, Dir, Symlink, Other };
+
+// type None : path does not exist (or cannot be stat'ed)
+struct Stat {
+    FileType                                type  = FileType::None;
+    u64                                     size  = 0;      // regular files only
+    std::chrono::system_clock::time_point   mtime {};
+    u32                                     mode  = 0;      // permission bits
+
+    bool exists()  const noexcept { return type != FileType::None; }
+    bool is_file() const noexcept { return type == FileType::File; }
+    bool is_dir()  const noexcept { return type == FileType::Dir;  }
+};
+
+namespace detail {
+#ifndef _WIN32
+inline Stat to_stat(const struct ::stat& sb) noexcept {
+    Stat r;
+    r.type = S_ISREG(sb.st_mode) ? FileType::File
+           : S_ISDIR(sb.st_mode) ? FileType::Dir
+           : S_ISLNK(sb.st_mode) ? FileType::Symlink
+           :                       FileType::Other;
+    r.size = S_ISREG(sb.st_mode) ? u64(sb.st_size) : 0;
+    r.mode = u32(sb.st_mode & 07777);
+#ifdef __APPLE__
+    auto ts = sb.st_mtimespec;
+#else
+    auto ts = sb.st_mtim;
+#endif
+    r.mtime = std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+              std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec)));
+    return r;
+}
+#endif
+} // namespace detail
+
+// one stat call; follow_links = false describes a symlink itself
+inline Stat stat(cStr& path, bool follow_links = true) noexcept {
+#ifdef _WIN32
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    auto st = follow_links ? fs::status(path, ec) : fs::symlink_status(path, ec);
+    if (ec || !fs::exists(st)) return {};
+    Stat r;
+    r.type = fs::is_regular_file(st) ? FileType::File
+           : fs::is_directory(st)    ? FileType::Dir
+           : fs::is_symlink(st)      ? FileType::Symlink
+           :                           FileType::Other;
+    if (r.type == FileType::File) r.size = fs::file_size(path, ec);
+    r.mode = u32(st.permissions()) & 07777;
+    auto t = fs::last_write_time(path, ec);
+    if (!ec) r.mtime = std::chrono::clock_cast<std::chrono::system_clock>(t);
+    return r;
+#else
+    struct ::stat sb{};
+    int rc = follow_links ? ::stat(path.c_str(), &sb) : ::lstat(path.c_str(), &sb);
+    return rc == 0 ? detail::to_stat(sb) : Stat{};
+#endif
+}
+
+// path -> Stat, entries trusted for ttl; for pollers hitting the same
+// files over and over. thread safe
+// x::StatCache cache(std::chrono::milliseconds(500));  cache.get(path).size
+class StatCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit StatCache(Clock::duration ttl = std::chrono::seconds(1), size_t max_entries = 1 << 16)
+        : ttl_(ttl), max_entries_(std::max<size_t>(max_entries, 1)) {}
+
+    Stat get(cStr& path) {
+        auto now = Clock::now();
+        {
+            std::lock_guard lk(m_);
+            auto it = map_.find(path);
+            if (it != map_.end() && now - it->second.at < ttl_) {
+                ++hits_;
+                return it->second.st;
+            }
+        }
+        Stat st = x::stat(path);   // outside the lock
+        std::lock_guard lk(m_);
+        if (map_.size() >= max_entries_ && !map_.contains(path)) evict(now);
+        map_.insert_or_assign(path, Entry{st, now});
+        return st;
+    }
+
+    bool exists(cStr& path)   { return get(path).exists();  }
+    u64  file_size(cStr& path) { return get(path).size;     }
+
+    void invalidate(cStr& path) {
+        std::lock_guard lk(m_);
+        map_.erase(path);
+    }
+
+    void clear() {
+        std::lock_guard lk(m_);
+        map_.clear();
+    }
+
+    size_t size() const {
+        std::lock_guard lk(m_);
+        return map_.size();
+    }
+
+    // lookups answered from the cache
+    u64 hits() const {
+        std::lock_guard lk(m_);
+        return hits_;
+    }
+
+private:
+    struct Entry {
+        Stat              st;
+        Clock::time_point at;
+    };
+
+    // drop expired entries, then the oldest until an eighth is free, so a
+    // working set just past max_entries stays mostly warm and the scan
+    // here runs once per max_entries / 8 inserts at most
+    void evict(Clock::time_point now) {
+        std::erase_if(map_, [&](const auto& kv) { return now - kv.second.at >= ttl_; });
+        size_t target = max_entries_ - max_entries_ / 8 - 1;
+        if (map_.size() <= target) return;
+        _vec<std::pair<Clock::time_point, _unmap<str, Entry>::iterator>> by_age;
+        by_age.reserve(map_.size());
+        for (auto it = map_.begin(); it != map_.end(); ++it) by_age.emplace_back(it->second.at, it);
+        size_t drop = map_.size() - target;
+        std::nth_element(by_age.begin(), by_age.begin() + (drop - 1), by_age.end(),
+                         [](const auto& a, const auto& b) { return a.first < b.first; });
+        for (size_t i = 0; i < drop; ++i) map_.erase(by_age[i].second);
+    }
+
+    Clock::duration              ttl_;
+    size_t                       max_entries_;
+    mutable std::mutex           m_;
+    _unmap<str, Entry>           map_;
+    u64                          hits_ = 0;
+};
+
+inline bool exists(cStr& path) noexcept {
+    return stat(path).exists();
+}
+
+inline bool is_file(cStr& path) noexcept {
+    return stat(path).is_file();
+}
+
+inline bool is_dir(cStr& path) noexcept {
+    return stat(path).is_dir();
+}
+
+// sized once, one read; falls back to chunked reads when the size is
+// unknown up front (pipes, /proc) or the file grows meanwhile
+inline str read_file(cStr& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) 
+        return "";
+    std::error_code ec;
+    u64 n = std::filesystem::file_size(path, ec);
+    str out(ec ? 0 : size_t(n), '\0');
+    file.read(out.data(), std::streamsize(out.size()));
+    out.resize(size_t(file.gcount()));
+    if (!file) return out;
+    char buf[64 * 1024];
+    while (file.read(buf, sizeof(buf)) || file.gcount() > 0)
+        out.append(buf, size_t(file.gcount()));
+    return out;
+}
+
+// contents of many files in one arena, see read_files
+class FileBatch {
+public:
+    struct File {
+        sView data;
+        i32   error = 0;    // errno, 0 : ok
+
+        bool ok() const noexcept { return error == 0; }
+    };
+
+    FileBatch() = default;
+    FileBatch(FileBatch&&) noexcept = default;
+    FileBatch& operator=(FileBatch&&) noexcept = default;
+
+    size_t      size()                 const noexcept { return files_.size();   }
+    bool        empty()                const noexcept { return files_.empty();  }
+    const File& operator[](size_t i)   const noexcept { return files_[i];       }
+    // bytes read over the whole batch
+    u64         bytes()                const noexcept { return bytes_;          }
+
+    auto begin() const noexcept { return files_.begin(); }
+    auto end()   const noexcept { return files_.end();   }
+
+private:
+    friend FileBatch read_files(std::span<const str> paths, u32 threads);
+
+    std::unique_ptr<char[]> arena_;
+    _vec<File>              files_;
+    u64                     bytes_ = 0;
+};
+
+namespace detail {
+#ifdef X_URING
+#ifdef X_TEST_HOOKS
+// test hook : after `after` more io_uring_enter calls, the next one fails with
+// err without reaching the kernel (-1 : never)
+struct UringFault {
+    i32 after = -1;
+    int err   = EIO;
+};
+inline thread_local UringFault uring_fault;
+#endif
+
+// minimal io_uring over the raw syscalls, driven by one thread : get() sqes,
+// then submit(wait) and reap() the completions. ok() is false when the
+// kernel has no io_uring (or it is disabled) or lacks one of the ops
+class Uring {
+public:
+    Uring(u32 entries, std::initializer_list<u8> ops) noexcept {
+        ::io_uring_params p{};
+        fd_ = int(::syscall(__NR_io_uring_setup, entries, &p));
+        if (fd_ < 0) return;
+        if (!(p.features & IORING_FEAT_SINGLE_MMAP) || !supports(ops)) { close(); return; }
+        ring_size_ = std::max<size_t>(p.sq_off.array + p.sq_entries * sizeof(u32),
+                                      p.cq_off.cqes + p.cq_entries * sizeof(::io_uring_cqe));
+        sqes_size_ = p.sq_entries * sizeof(::io_uring_sqe);
+        ring_ = ::mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+        if (ring_ == MAP_FAILED) { close(); return; }
+        void* sq = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+        if (sq == MAP_FAILED) { close(); return; }
+        sqes_     = static_cast<::io_uring_sqe*>(sq);
+        auto base = static_cast<char*>(ring_);
+        sq_head_  = reinterpret_cast<u32*>(base + p.sq_off.head);
+        sq_tail_  = reinterpret_cast<u32*>(base + p.sq_off.tail);
+        sq_array_ = reinterpret_cast<u32*>(base + p.sq_off.array);
+        cq_head_  = reinterpret_cast<u32*>(base + p.cq_off.head);
+        cq_tail_  = reinterpret_cast<u32*>(base + p.cq_off.tail);
+        cqes_     = reinterpret_cast<::io_uring_cqe*>(base + p.cq_off.cqes);
+        sq_mask_  = *reinterpret_cast<u32*>(base + p.sq_off.ring_mask);
+        cq_mask_  = *reinterpret_cast<u32*>(base + p.cq_off.ring_mask);
+        entries_  = p.sq_entries;
+        tail_     = *sq_tail_;
+    }
+
+    ~Uring() { close(); }
+
+    Uring(const Uring&) = delete;
+    Uring& operator=(const Uring&) = delete;
+
+    bool ok()      const noexcept { return sqes_ != nullptr; }
+    u32  entries() const noexcept { return entries_; }
+
+    // a zeroed sqe, nullptr when the queue is full
+    ::io_uring_sqe* get() noexcept {
+        if (tail_ - std::atomic_ref<u32>(*sq_head_).load(std::memory_order_acquire) >= entries_) return nullptr;
+        u32 i = tail_ & sq_mask_;
+        sq_array_[i] = i;
+        ++tail_;
+        ++queued_;
+        std::memset(&sqes_[i], 0, sizeof(::io_uring_sqe));
+        return &sqes_[i];
+    }
+
+    // hand queued sqes to the kernel and wait for at least wait completions;
+    // 0 or -errno
+    int submit(u32 wait) noexcept {
+        std::atomic_ref<u32>(*sq_tail_).store(tail_, std::memory_order_release);
+#ifdef X_TEST_HOOKS
+        if (uring_fault.after >= 0 && uring_fault.after-- == 0) return -uring_fault.err;
+#endif
+        for (;;) {
+            long r = ::syscall(__NR_io_uring_enter, fd_, queued_, wait, wait ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+            if (r >= 0) {
+                queued_ -= u32(r);
+                return 0;
+            }
+            if (errno != EINTR) return -errno;
+        }
+    }
+
+    // fn(user_data, res) for every completion ready
+    template<typename F>
+    void reap(F&& fn) {
+        std::atomic_ref<u32> tail(*cq_tail_), head(*cq_head_);
+        u32 h = head.load(std::memory_order_relaxed);
+        for (u32 t = tail.load(std::memory_order_acquire); h != t; ++h) {
+            const auto& c = cqes_[h & cq_mask_];
+            fn(c.user_data, c.res);
+        }
+        head.store(h, std::memory_order_release);
+    }
+
+    // take back the sqes the kernel has not consumed, fn(user_data) for each
+    template<typename F>
+    void unqueue(F&& fn) {
+        u32 head = std::atomic_ref<u32>(*sq_head_).load(std::memory_order_acquire);
+        for (u32 i = head; i != tail_; ++i) fn(sqes_[i & sq_mask_].user_data);
+        tail_   = head;
+        queued_ = 0;
+        std::atomic_ref<u32>(*sq_tail_).store(tail_, std::memory_order_release);
+    }
+
+private:
+    bool supports(std::initializer_list<u8> ops) noexcept {
+        constexpr u32 kOps = 256;
+        alignas(::io_uring_probe) u8 buf[sizeof(::io_uring_probe) + kOps * sizeof(::io_uring_probe_op)] = {};
+        auto probe = reinterpret_cast<::io_uring_probe*>(buf);
+        if (::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, probe, kOps) < 0) return false;
+        for (u8 op : ops)
+            if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) return false;
+        return true;
+    }
+
+    void close() noexcept {
+        if (sqes_) ::munmap(sqes_, sqes_size_);
+        if (ring_ && ring_ != MAP_FAILED) ::munmap(ring_, ring_size_);
+        if (fd_ >= 0) ::close(fd_);
+        sqes_ = nullptr;
+        ring_ = nullptr;
+        fd_   = -1;
+    }
+
+    int             fd_        = -1;
+    void*           ring_      = nullptr;
+    size_t          ring_size_ = 0;
+    ::io_uring_sqe* sqes_      = nullptr;
+    size_t          sqes_size_ = 0;
+    ::io_uring_cqe* cqes_      = nullptr;
+    u32*            sq_head_   = nullptr;
+    u32*            sq_tail_   = nullptr;
+    u32*            sq_array_  = nullptr;
+    u32*            cq_head_   = nullptr;
+    u32*            cq_tail_   = nullptr;
+    u32             sq_mask_   = 0;
+    u32             cq_mask_   = 0;
+    u32             entries_   = 0;
+    u32             tail_      = 0;     // local sq tail, published by submit
+    u32             queued_    = 0;     // sqes not yet taken by the kernel
+};
+#endif
+} // namespace detail
+
+namespace detail {
+#ifdef X_URING
+// read_files over io_uring : a statx per path sizes the arena, then each file
+// goes open -> read (repeated on short reads) -> close, up to entries() ops in
+// flight and one io_uring_enter per round for all of them.
+// false : no usable ring, or io_uring_enter failed; files, offs and arena are
+// left as they came in so the caller can redo the batch another way
+inline bool uring_read_files(std::span<const str> paths, std::span<FileBatch::File> files,
+                             _vec<u64>& offs, std::unique_ptr<char[]>& arena) {
+    Uring ring(256, {IORING_OP_STATX, IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_CLOSE});
+    if (!ring.ok()) return false;
+    const size_t n = paths.size();
+    const u32    slots = ring.entries();
+
+    struct Job {
+        size_t i   = 0;
+        int    fd  = -1;
+        size_t got = 0;
+    };
+    enum : u8 { Stat, Open, Read, Close };
+    _vec<Job>                stx_job(slots);
+    _vec<struct ::statx>     stx(slots);
+    _vec<Job>                jobs(slots);
+    _vec<u32>                free_slots(slots);
+    _vec<u64>                deferred;      // (slot << 2 | op) that found the sq full
+    std::iota(free_slots.rbegin(), free_slots.rend(), 0u);
+    size_t next = 0, live = 0;
+    int    fatal = 0;
+    char*  base  = nullptr;
+
+    auto cap = [&](size_t i) { return size_t(offs[i + 1] - offs[i]); };
+    auto issue = [&](u32 slot, u8 op) {
+        ::io_uring_sqe* e = ring.get();
+        if (!e) {
+            deferred.push_back(u64(slot) << 2 | op);
+            return;
+        }
+        Job& j = op == Stat ? stx_job[slot] : jobs[slot];
+        e->user_data = u64(slot) << 2 | op;
+        switch (op) {
+        case Stat:
+            e->opcode      = IORING_OP_STATX;
+            e->fd          = AT_FDCWD;
+            e->addr        = u64(uintptr_t(paths[j.i].c_str()));
+            e->len         = STATX_TYPE | STATX_SIZE;
+            e->off         = u64(uintptr_t(&stx[slot]));
+            break;
+        case Open:
+            e->opcode      = IORING_OP_OPENAT;
+            e->fd          = AT_FDCWD;
+            e->addr        = u64(uintptr_t(paths[j.i].c_str()));
+            e->open_flags  = O_RDONLY | O_CLOEXEC;
+            break;
+        case Read:
+            e->opcode      = IORING_OP_READ;
+            e->fd          = j.fd;
+            e->addr        = u64(uintptr_t(base + offs[j.i] + j.got));
+            e->len         = u32(std::min<size_t>(cap(j.i) - j.got, 1u << 30));
+            e->off         = j.got;
+            break;
+        default:
+            e->opcode      = IORING_OP_CLOSE;
+            e->fd          = j.fd;
+            break;
+        }
+    };
+    auto done = [&](u32 slot) {
+        free_slots.push_back(slot);
+        --live;
+    };
+    // after a fatal enter error nothing reaches the kernel any more : the
+    // next op of a slot is dropped here and its fd closed
+    auto retire = [&](u32 slot, u8 op) {
+        if (op != Stat && jobs[slot].fd >= 0) ::close(jobs[slot].fd);
+        done(slot);
+    };
+    auto then = [&](u32 slot, u8 op) {
+        if (fatal) retire(slot, op);
+        else       issue(slot, op);
+    };
+    auto complete = [&](u64 ud, i32 res) {
+        u32 slot = u32(ud >> 2);
+        u8  op   = u8(ud & 3);
+        if (op == Stat) {
+            auto& f = files[stx_job[slot].i];
+            auto& s = stx[slot];
+            if (res < 0)                 f.error = -res;
+            else if (S_ISDIR(s.stx_mode)) f.error = EISDIR;
+            else if (!S_ISREG(s.stx_mode)) f.error = EINVAL;
+            else                         offs[stx_job[slot].i + 1] = s.stx_size;
+            return done(slot);
+        }
+        Job&  j = jobs[slot];
+        auto& f = files[j.i];
+        switch (op) {
+        case Open:
+            if (res < 0) {
+                f.error = -res;
+                return done(slot);
+            }
+            j.fd = res;
+            return then(slot, cap(j.i) ? Read : Close);
+        case Read:
+            if (res == -EINTR || res == -EAGAIN) return then(slot, Read);
+            if (res < 0) f.error = -res;
+            else         j.got += size_t(res);
+            // done, failed, or shrank since the statx (read 0)
+            if (res <= 0 || j.got == cap(j.i)) return then(slot, Close);
+            return then(slot, Read);
+        default:
+            if (f.ok()) f.data = sView(base + offs[j.i], j.got);
+            return done(slot);
+        }
+    };
+    // feed new work through start(slot) while slots are free, until all is done
+    auto run = [&](auto&& start) {
+        next = 0;
+        while ((!fatal && next < n) || live) {
+            for (auto d : std::exchange(deferred, {})) then(u32(d >> 2), u8(d & 3));
+            while (!fatal && next < n && !free_slots.empty() && deferred.empty()) {
+                u32 slot = free_slots.back();
+                if (!start(slot, next++)) continue;
+                free_slots.pop_back();
+                ++live;
+            }
+            if (!live) continue;
+            if (!fatal) {
+                int r = ring.submit(1);
+                if (r == -EAGAIN || r == -EBUSY) std::this_thread::yield();
+                else if (r < 0) {
+                    fatal = -r;
+                    // whatever the failed enter left queued never runs
+                    ring.unqueue([&](u64 ud) { retire(u32(ud >> 2), u8(ud & 3)); });
+                }
+            } else {
+                // submitted work still completes : drain it before buffers go away
+                std::this_thread::yield();
+            }
+            ring.reap(complete);
+        }
+    };
+
+    // nothing is in flight once run() returns : undo the batch for the caller
+    auto undo = [&] {
+        std::fill(files.begin(), files.end(), FileBatch::File{});
+        std::fill(offs.begin(), offs.end(), 0);
+        arena.reset();
+        return false;
+    };
+
+    run([&](u32 slot, size_t i) {
+        stx_job[slot].i = i;
+        issue(slot, Stat);
+        return true;
+    });
+    if (fatal) return undo();
+    std::partial_sum(offs.begin(), offs.end(), offs.begin());
+    arena.reset(new char[std::max<u64>(offs[n], 1)]);
+    base = arena.get();
+    run([&](u32 slot, size_t i) {
+        if (!files[i].ok()) return false;
+        jobs[slot] = Job{i, -1, 0};
+        issue(slot, Open);
+        return true;
+    });
+    return fatal ? undo() : true;
+}
+#endif
+} // namespace detail
+
+// read a batch of files : sizes first, then a single arena for all contents.
+// on linux opens, reads and closes are batched through io_uring; elsewhere,
+// or when io_uring is unavailable or fails, a pool of threads does them
+// views stay valid as long as the batch; files are sized when the batch
+// starts, so pseudo files (/proc) read as empty
+// auto batch = x::read_files(paths);  if (batch[i].ok()) use(batch[i].data);
+inline FileBatch read_files(std::span<const str> paths, u32 threads = 0) {
+    FileBatch b;
+    size_t n = paths.size();
+    b.files_.resize(n);
+    _vec<u64> offs(n + 1, 0);
+#ifdef X_URING
+    if (detail::uring_read_files(paths, b.files_, offs, b.arena_)) {
+        for (auto& f : b.files_) b.bytes_ += f.data.size();
+        return b;
+    }
+#endif
+    // one pool for both passes : workers stat their range, meet while the
+    // arena is laid out, then read the same range
+    bool laid = true;
+    std::barrier sync(ptrdiff_t(detail::pool_workers(n, 32, threads)), [&]() noexcept {
+        std::partial_sum(offs.begin(), offs.end(), offs.begin());
+        b.arena_.reset(new (std::nothrow) char[std::max<u64>(offs[n], 1)]);
+        laid = b.arena_ != nullptr;
+    });
+    detail::parallel_for(n, 32, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            Stat st = stat(paths[i]);
+            if (!st.exists())      b.files_[i].error = ENOENT;
+            else if (!st.is_file()) b.files_[i].error = st.is_dir() ? EISDIR : EINVAL;
+            offs[i + 1] = st.size;
+        }
+        sync.arrive_and_wait();
+        if (!laid) return;
+        for (size_t i = lo; i < hi; ++i) {
+            auto& f = b.files_[i];
+            if (!f.ok()) continue;
+            char*  dst = b.arena_.get() + offs[i];
+            size_t cap = size_t(offs[i + 1] - offs[i]), got = 0;
+#ifdef _WIN32
+            std::ifstream file(paths[i], std::ios::binary);
+            if (!file.is_open()) {
+                f.error = ENOENT;
+                continue;
+            }
+            file.read(dst, std::streamsize(cap));
+            got = size_t(file.gcount());
+#else
+            int fd = ::open(paths[i].c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                f.error = errno;
+                continue;
+            }
+            while (got < cap) {
+                ssize_t r = ::read(fd, dst + got, cap - got);
+                if (r < 0 && errno == EINTR) continue;
+                if (r < 0) {
+                    f.error = errno;
+                    break;
+                }
+                if (r == 0) break;  // shrank since the stat
+                got += size_t(r);
+            }
+            ::close(fd);
+#endif
+            f.data = sView(dst, got);
+        }
+    }, threads);
+    if (!laid) throw std::bad_alloc();
+    for (auto& f : b.files_) b.bytes_ += f.data.size();
+    return b;
+}
+
+// binary, truncating unless append
+// atomic : write to a temp file next to path, then rename it over path,
+//          readers see the old or the new content, never a mix
+// sync   : data is on disk when the call returns (fdatasync, plus the
+//          directory entry for atomic)
+struct WriteOptions {
+    bool append = false;
+    bool atomic = false;    // not with append
+    bool sync   = false;
+};
+
+namespace detail {
+#ifndef _WIN32
+inline void write_all(int fd, std::span<const sView> parts, cStr& path) {
+#ifdef IOV_MAX
+    constexpr size_t kMaxIov = IOV_MAX < 1024 ? IOV_MAX : 1024;
+#else
+    constexpr size_t kMaxIov = 1024;
+#endif
+    ::iovec iov[kMaxIov];
+    size_t  next = 0;           // first part not yet queued
+    size_t  skip = 0;           // bytes of parts[next] already written
+    while (next < parts.size()) {
+        size_t n = 0;
+        for (size_t i = next; i < parts.size() && n < kMaxIov; ++i) {
+            size_t off = i == next ? skip : 0;
+            if (parts[i].size() == off) continue;
+            iov[n].iov_base = const_cast<char*>(parts[i].data() + off);
+            iov[n].iov_len  = parts[i].size() - off;
+            ++n;
+        }
+        if (n == 0) break;
+        ssize_t w = ::writev(fd, iov, int(n));
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(_fmt("Failed to write file: {} ({})", path, std::strerror(errno)));
+        }
+        // advance over what went out, partial writes included
+        size_t left = size_t(w);
+        while (next < parts.size() && left >= parts[next].size() - skip) {
+            left -= parts[next].size() - skip;
+            skip  = 0;
+            ++next;
+        }
+        skip += left;
+    }
+}
+
+inline void sync_dir(cStr& path) {
+    auto dir = std::filesystem::path(path).parent_path();
+    int  fd  = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    ::fsync(fd);
+    ::close(fd);
+}
+#endif
+} // namespace detail
+
+// several buffers written in one go (writev), nothing is concatenated
+inline void write_file(cStr& path, std::span<const sView> parts, const WriteOptions& opt = WriteOptions{}) {
+    if (opt.append && opt.atomic)
+        throw std::runtime_error(_fmt("write_file: append and atomic are exclusive: {}", path));
+    static std::atomic<u32> seq{0};
+    cStr target = opt.atomic
+                ? _fmt("{}.tmp.{}.{}", path, std::chrono::steady_clock::now().time_since_epoch().count(), seq++)
+                : path;
+#ifdef _WIN32
+    {
+        std::ofstream file(target, std::ios::binary | (opt.append ? std::ios::app : std::ios::trunc));
+        if (!file.is_open()) {
+            throw std::runtime_error(_fmt("Failed to open file: {}", path));
+        }
+        for (const auto& p : parts) file.write(p.data(), std::streamsize(p.size()));
+        file.flush();
+        if (!file) throw std::runtime_error(_fmt("Failed to write file: {}", path));
+    }
+    if (opt.atomic) std::filesystem::rename(target, path);
+#else
+    int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (opt.append ? O_APPEND : O_TRUNC);
+    int fd    = ::open(target.c_str(), flags, 0666);
+    if (fd < 0) {
+        throw std::runtime_error(_fmt("Failed to open file: {}", path));
+    }
+    try {
+        if (opt.atomic) {
+            // keep the permissions of the file being replaced
+            struct ::stat st{};
+            if (::stat(path.c_str(), &st) == 0) ::fchmod(fd, st.st_mode & 07777);
+        }
+        detail::write_all(fd, parts, path);
+#ifdef __APPLE__
+        if (opt.sync && ::fsync(fd) != 0)
+#else
+        if (opt.sync && ::fdatasync(fd) != 0)
+#endif
+            throw std::runtime_error(_fmt("Failed to sync file: {} ({})", path, std::strerror(errno)));
+    } catch (...) {
+        ::close(fd);
+        if (opt.atomic) ::unlink(target.c_str());
+        throw;
+    }
+    ::close(fd);
+    if (opt.atomic) {
+        if (::rename(target.c_str(), path.c_str()) != 0) {
+            int err = errno;
+            ::unlink(target.c_str());
+            throw std::runtime_error(_fmt("Failed to replace file: {} ({})", path, std::strerror(err)));
+        }
+        if (opt.sync) detail::sync_dir(path);
+    }
+#endif
+}
+
+inline void write_file(cStr& path, std::initializer_list<sView> parts, const WriteOptions& opt = WriteOptions{}) {
+    write_file(path, std::span<const sView>(parts.begin(), parts.size()), opt);
+}
+
+inline void write_file(cStr& path, cSView& content, const WriteOptions& opt = WriteOptions{}) {
+    write_file(path, std::span<const sView>(&content, 1), opt);
+}
+
+inline str join_path(const _vec<str>& parts) {
+    std::filesystem::path result;
+    for (const auto& part : parts) {
+        result /= part;
+    }
+    return result.string();
+}
+
+inline _vec<str> split_path(cStr& path) {
+    _vec<str> result;
+    for (const auto& part : std::filesystem::path(path)) {
+        result.push_back(part.string());
+    }
+    return result;
+}
+
+inline str norm_path(cStr& path) {
+    return std::filesystem::path(path).lexically_normal().string();
+}
+
+// 0 for missing paths and anything but regular files
+inline u64 file_size(cStr& path) noexcept {
+    return stat(path).size;
+}
+
+inline _vec<str> list_dir(cStr& path) {
+    if (!std::filesystem::exists(path)) return {};
+    _vec<str> result;
+    for (const auto& entry : std::filesystem::directory_iterator(path)) {
+        result.push_back(entry.path().string());
+    }
+    return result;
+}
+
+inline void create_dir(cStr& path) {
+    std::filesystem::create_directory(path);
+}
+
+inline void remove_file(cStr& path) {
+    std::filesystem::remove(path);
+}
+
+inline void remove_dir(cStr& path) {
+    std::filesystem::remove_all(path);
+}
+
+// local "YYYY-MM-DD HH:MM:SS", empty if path is missing
+inline str file_time(cStr& path) {
+    Stat st = stat(path);
+    if (!st.exists()) return "";
+    std::time_t t = std::chrono::system_clock::to_time_t(st.mtime);
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
+    char buf[32];
+    return str(buf, std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm));
+}
+
+// ----------------------- walk -----------------------
+
+struct WalkEntry {
+    str                                     path;
+    FileType                                type  = FileType::None;
+    u64                                     size  = 0;
+    std::chrono::system_clock::time_point   mtime {};
+    u32                                     depth = 0;      // 1 : direct child of the root
+
+    sView name() const noexcept {
+        size_t p = path.find_last_of("/\\");
+        return p == str::npos ? sView(path) : sView(path).substr(p + 1);
+    }
+};
+
+// filters (extensions, glob) apply to non-directories; directories are
+// still descended into when they are filtered out of the result
+struct WalkOptions {
+    i32         max_depth    = -1;      // -1 : unlimited, 1 : direct children only
+    _vec<str>   extensions;             // without dot : {"cpp", "h"}
+    str         glob;                   // on the file name : * ? [a-z] [!x]
+    bool        include_dirs = true;
+    bool        skip_hidden  = false;   // names starting with '.'
+    bool        follow_links = false;   // descend into symlinked dirs (cycles are skipped)
+    bool        stat         = true;    // fill size / mtime (one fstatat per entry)
+    size_t      max_entries  = 0;       // 0 : no limit
+    u32         threads      = 0;       // 0 : hardware concurrency
+    // called for each accepted entry (serialized), return false to stop the walk
+    std::function<bool(const WalkEntry&)> on_entry;
+};
+
+namespace detail {
+// [...] set starting at pat[p], moves p past it
+inline bool glob_set(sView pat, size_t& p, char c) noexcept {
+    size_t q   = p + 1;
+    bool   neg = q < pat.size() && (pat[q] == '!' || pat[q] == '^');
+    if (neg) ++q;
+    size_t close = pat.find(']', q + 1);  // a ']' first in the set is literal
+    if (close == sView::npos) {
+        ++p;                              // unterminated : literal '['
+        return c == '[';
+    }
+    bool hit = false;
+    for (size_t k = q; k < close; ++k) {
+        if (k + 2 < close && pat[k + 1] == '-') {
+            hit |= pat[k] <= c && c <= pat[k + 2];
+            k += 2;
+        } else {
+            hit |= pat[k] == c;
+        }
+    }
+    p = close + 1;
+    return hit != neg;
+}
+
+// shell-style match : * ? [abc] [a-z] [!abc]
+inline bool glob_match(sView pat, sView s) noexcept {
+    size_t p = 0, i = 0, star = sView::npos, mark = 0;
+    while (i < s.size()) {
+        if (p < pat.size() && pat[p] == '*') {
+            star = p++;
+            mark = i;
+            continue;
+        }
+        if (p < pat.size()) {
+            size_t pp = p;
+            bool   ok = pat[p] == '?' ? (++pp, true)
+                      : pat[p] == '[' ? glob_set(pat, pp, s[i])
+                      : pat[p] == s[i] && (++pp, true);
+            if (ok) {
+                p = pp;
+                ++i;
+                continue;
+            }
+        }
+        if (star == sView::npos) return false;
+        p = star + 1;
+        i = ++mark;
+    }
+    while (p < pat.size() && pat[p] == '*') ++p;
+    return p == pat.size();
+}
+
+inline bool walk_accept(const WalkOptions& opt, const WalkEntry& e) {
+    if (e.type == FileType::Dir) return opt.include_dirs;
+    sView name = e.name();
+    if (!opt.extensions.empty()) {
+        size_t dot = name.find_last_of('.');
+        if (dot == sView::npos) return false;
+        sView ext = name.substr(dot + 1);
+        if (std::find(opt.extensions.begin(), opt.extensions.end(), ext) == opt.extensions.end())
+            return false;
+    }
+    return opt.glob.empty() || glob_match(opt.glob, name);
+}
+
+struct WalkState {
+    const WalkOptions&              opt;
+    std::mutex                      m;
+    std::condition_variable         cv;
+    _vec<std::pair<str, u32>>       dirs;       // pending (path, depth)
+    size_t                          busy = 0;
+    std::atomic<bool>               stop{false};
+    std::mutex                      out_m;
+    _vec<WalkEntry>                 out;
+    std::set<std::pair<u64, u64>>   seen;       // (dev, inode) of dirs, follow_links only
+
+    explicit WalkState(const WalkOptions& o) : opt(o) {}
+
+    // false once the walk must stop
+    bool emit(WalkEntry&& e) {
+        std::lock_guard lk(out_m);
+        if (stop) return false;
+        if (opt.on_entry && !opt.on_entry(e)) stop = true;
+        out.push_back(std::move(e));
+        if (opt.max_entries && out.size() >= opt.max_entries) stop = true;
+        return !stop;
+    }
+
+    bool first_visit(u64 dev, u64 ino) {
+        std::lock_guard lk(out_m);
+        return seen.insert({dev, ino}).second;
+    }
+};
+
+inline void walk_dir(WalkState& st, cStr& dir, u32 depth, _vec<std::pair<str, u32>>& subdirs) {
+    const auto& opt = st.opt;
+    bool descend = opt.max_depth < 0 || i32(depth) + 1 < opt.max_depth;   // children are at depth + 1
+    str  prefix  = dir;
+    if (!prefix.empty() && prefix.back() != '/' && prefix.back() != '\\') prefix += '/';
+#ifdef _WIN32
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(dir, ec), end; !ec && it != end && !st.stop; it.increment(ec)) {
+        WalkEntry e;
+        e.path  = prefix + it->path().filename().string();
+        e.depth = depth + 1;
+        if (opt.skip_hidden && e.name().starts_with('.')) continue;
+        std::error_code ec2;
+        auto s = opt.follow_links ? it->status(ec2) : it->symlink_status(ec2);
+        e.type = std::filesystem::is_regular_file(s) ? FileType::File
+               : std::filesystem::is_directory(s)    ? FileType::Dir
+               : std::filesystem::is_symlink(s)      ? FileType::Symlink
+               :                                       FileType::Other;
+        if (opt.stat) {
+            if (e.type == FileType::File) e.size = it->file_size(ec2);
+            e.mtime = std::chrono::clock_cast<std::chrono::system_clock>(it->last_write_time(ec2));
+        }
+        if (e.type == FileType::Dir && descend) subdirs.emplace_back(e.path, depth + 1);
+        if (walk_accept(opt, e) && !st.emit(std::move(e))) return;
+    }
+#else
+    DIR* d = ::opendir(dir.c_str());
+    if (!d) return;
+    int fd = ::dirfd(d);
+    while (!st.stop) {
+        ::dirent* de = ::readdir(d);
+        if (!de) break;
+        sView name = de->d_name;
+        if (name == "." || name == "..") continue;
+        if (opt.skip_hidden && name[0] == '.') continue;
+        WalkEntry e;
+        e.type = de->d_type == DT_REG ? FileType::File
+               : de->d_type == DT_DIR ? FileType::Dir
+               : de->d_type == DT_LNK ? FileType::Symlink
+               : de->d_type == DT_UNKNOWN ? FileType::None
+               :                        FileType::Other;
+        bool link = e.type == FileType::Symlink && opt.follow_links;
+        struct ::stat sb{};
+        bool have = false;
+        // following links, every directory needs its dev/inode for the cycle check
+        if (opt.stat || e.type == FileType::None || link || (opt.follow_links && e.type == FileType::Dir)) {
+            have = ::fstatat(fd, de->d_name, &sb, link ? 0 : AT_SYMLINK_NOFOLLOW) == 0;
+            if (have) {
+                Stat r  = to_stat(sb);
+                e.type  = r.type;
+                e.size  = r.size;
+                e.mtime = r.mtime;
+            }
+        }
+        e.path.reserve(prefix.size() + name.size());
+        e.path.append(prefix).append(name);
+        e.depth = depth + 1;
+        if (e.type == FileType::Dir && descend) {
+            if (!opt.follow_links || (have && st.first_visit(u64(sb.st_dev), u64(sb.st_ino))))
+                subdirs.emplace_back(e.path, depth + 1);
+        }
+        if (!opt.stat) {
+            e.size  = 0;
+            e.mtime = {};
+        }
+        if (walk_accept(opt, e) && !st.emit(std::move(e))) break;
+    }
+    ::closedir(d);
+#endif
+}
+} // namespace detail
+
+// recursive listing over a pool of workers, one stat per entry
+// order of the result is unspecified, sort it if needed
+// auto src = x::walk("src", {.extensions = {"cpp", "h"}});
+inline _vec<WalkEntry> walk(cStr& root, const WalkOptions& opt = WalkOptions{}) {
+    if (!is_dir(root) || opt.max_depth == 0) return {};
+    detail::WalkState st(opt);
+    st.dirs.emplace_back(root, 0);
+    if (opt.follow_links) {
+#ifndef _WIN32
+        struct ::stat sb{};
+        if (::stat(root.c_str(), &sb) == 0) st.first_visit(u64(sb.st_dev), u64(sb.st_ino));
+#endif
+    }
+    auto worker = [&st] {
+        _vec<std::pair<str, u32>> found;
+        std::unique_lock lk(st.m);
+        for (;;) {
+            st.cv.wait(lk, [&] { return !st.dirs.empty() || st.busy == 0 || st.stop; });
+            if (st.stop || st.dirs.empty()) break;   // stopped, or nothing queued and nobody busy
+            auto [dir, depth] = std::move(st.dirs.back());
+            st.dirs.pop_back();
+            ++st.busy;
+            lk.unlock();
+            found.clear();
+            detail::walk_dir(st, dir, depth, found);
+            lk.lock();
+            --st.busy;
+            for (auto& f : found) st.dirs.push_back(std::move(f));
+            st.cv.notify_all();
+        }
+        st.cv.notify_all();
+    };
+    u32 threads = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+    _vec<std::thread> pool;
+    for (u32 i = 1; i < threads; ++i) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+    return std::move(st.out);
+}
+
+// ----------------------- MappedFile -----------------------
+// read-only mapping of a whole file, views stay valid while it is open
+// x::MappedFile m("huge.log", {.advice = x::MapAdvice::Sequential});
+// if (m.is_open() && x::contain(m.view(), "ERROR")) ...
+// (no mmap on windows : the file is read into memory instead)
+enum class MapAdvice : u8 { Normal, Sequential, Random, WillNeed };
+
+struct MapOptions {
+    MapAdvice advice     = MapAdvice::Sequential;
+    bool      huge_pages = false;   // transparent huge pages, best effort
+    bool      populate   = false;   // prefault the whole file up front
+};
+
+class MappedFile {
+public:
+    MappedFile() noexcept = default;
+    explicit MappedFile(cStr& path) { open(path, MapOptions{}); }
+    MappedFile(cStr& path, const MapOptions& opt) { open(path, opt); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept { take(other); }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            take(other);
+        }
+        return *this;
+    }
+
+    bool open(cStr& path, const MapOptions& opt = MapOptions{}) {
+        close();
+#ifdef _WIN32
+        (void)opt;
+        if (!is_file(path)) return false;
+        owned_ = read_file(path);
+        data_  = owned_.data();
+        size_  = owned_.size();
+        open_  = true;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct ::stat st{};
+        if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            ::close(fd);
+            return false;
+        }
+        size_ = size_t(st.st_size);
+        if (size_ > 0) {
+            int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+            if (opt.populate) flags |= MAP_POPULATE;
+#endif
+            void* p = ::mmap(nullptr, size_, PROT_READ, flags, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                size_ = 0;
+                return false;
+            }
+            data_ = static_cast<const char*>(p);
+#ifdef MADV_HUGEPAGE
+            if (opt.huge_pages) ::madvise(p, size_, MADV_HUGEPAGE);
+#endif
+            advise(opt.advice);
+        }
+        ::close(fd); // the mapping keeps the file alive
+        open_ = true;
+#endif
+        return true;
+    }
+
+    void close() noexcept {
+#ifdef _WIN32
+        owned_ = {};
+#else
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+        open_ = false;
+    }
+
+    // hint the kernel about the access pattern of [off, off + len)
+    bool advise(MapAdvice a, size_t off = 0, size_t len = sView::npos) noexcept {
+#ifdef _WIN32
+        (void)a; (void)off; (void)len;
+        return open_;
+#else
+        if (!data_ || off >= size_) return false;
+        len = std::min(len, size_ - off);
+        // madvise wants a page aligned start
+        static const size_t page = size_t(::sysconf(_SC_PAGESIZE));
+        size_t skew = off % page;
+        int    adv  = a == MapAdvice::Sequential ? MADV_SEQUENTIAL
+                    : a == MapAdvice::Random     ? MADV_RANDOM
+                    : a == MapAdvice::WillNeed   ? MADV_WILLNEED
+                    :                              MADV_NORMAL;
+        return ::madvise(const_cast<char*>(data_) + off - skew, len + skew, adv) == 0;
+#endif
+    }
+
+    bool                    is_open() const noexcept { return open_;                                    }
+    bool                    empty()   const noexcept { return size_ == 0;                               }
+    size_t                  size()    const noexcept { return size_;                                    }
+    const char*             data()    const noexcept { return data_;                                    }
+    sView                   view()    const noexcept { return {data_, size_};                           }
+    std::span<const u8>     bytes()   const noexcept { return {reinterpret_cast<const u8*>(data_), size_}; }
+
+    operator sView()                  const noexcept { return view();                                   }
+
+private:
+    void take(MappedFile& other) noexcept {
+#ifdef _WIN32
+        owned_ = std::move(other.owned_);
+        data_  = owned_.data();
+#else
+        data_  = other.data_;
+#endif
+        size_  = other.size_;
+        open_  = other.open_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.open_ = false;
+    }
+
+    const char* data_ = nullptr;
+    size_t      size_ = 0;
+    bool        open_ = false;
+#ifdef _WIN32
+    str         owned_;
+#endif
+};
+
+// ----------------------- hash -----------------------
+// fast non-cryptographic hashing for dedupe, integrity checks and keys
+// outputs are stable : the same on every platform, build and run
+//   hash_bytes     64 bit,  bit-exact XXH3_64bits_withSeed  (xxHash 0.8)
+//   hash_bytes128  128 bit, bit-exact XXH3_128bits_withSeed
+//   crc32c         crc-32/iscsi (Castagnoli), sse4.2 crc32 when the cpu has it
+// so `xxhsum -H3 file` prints the same value as hash_file(file)
+//
+// u64  h = x::hash_bytes(record);
+// auto d = x::hash_file128("disk.img", {.chunk = 64 << 20});  // parallel tree
+struct Hash128 {
+    u64 lo = 0;
+    u64 hi = 0;
+
+    bool operator==(const Hash128&) const noexcept = default;
+
+    // canonical form : hi then lo, 32 lowercase hex digits (as xxhsum prints)
+    str hex() const {
+        static constexpr char digits[] = "0123456789abcdef";
+        str out(32, '0');
+        for (int i = 0; i < 16; ++i) {
+            out[15 - i] = digits[(hi >> (4 * i)) & 0xF];
+            out[31 - i] = digits[(lo >> (4 * i)) & 0xF];
+        }
+        return out;
+    }
+};
+
+namespace detail::xxh {
+
+inline constexpr u64 P32_1 = 0x9E3779B1U;
+inline constexpr u64 P32_2 = 0x85EBCA77U;
+inline constexpr u64 P32_3 = 0xC2B2AE3DU;
+inline constexpr u64 P64_1 = 0x9E3779B185EBCA87ULL;
+inline constexpr u64 P64_2 = 0xC2B2AE3D27D4EB4FULL;
+inline constexpr u64 P64_3 = 0x165667B19E3779F9ULL;
+inline constexpr u64 P64_4 = 0x85EBCA77C2B2AE63ULL;
+inline constexpr u64 P64_5 = 0x27D4EB2F165667C5ULL;
+inline constexpr u64 MX1   = 0x165667919E3779F9ULL;
+inline constexpr u64 MX2   = 0x9FB21C651E98DF25ULL;
+
+inline constexpr size_t kSecretSize   = 192;
+inline constexpr size_t kStripe       = 64;
+inline constexpr size_t kBlockStripes = (kSecretSize - kStripe) / 8;   // per scramble
+inline constexpr size_t kMidMax       = 240;
+
+alignas(64) inline constexpr u8 kSecret[kSecretSize] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+constexpr u32 bswap32(u32 v) noexcept {
+    return (v >> 24) | ((v >> 8) & 0xFF00) | ((v << 8) & 0xFF0000) | (v << 24);
+}
+
+constexpr u64 bswap64(u64 v) noexcept {
+    return (u64(bswap32(u32(v))) << 32) | bswap32(u32(v >> 32));
+}
+
+inline u32 rd32(const u8* p) noexcept {
+    u32 v;
+    std::memcpy(&v, p, 4);
+    if constexpr (std::endian::native == std::endian::big) v = bswap32(v);
+    return v;
+}
+
+inline u64 rd64(const u8* p) noexcept {
+    u64 v;
+    std::memcpy(&v, p, 8);
+    if constexpr (std::endian::native == std::endian::big) v = bswap64(v);
+    return v;
+}
+
+inline void wr64(u8* p, u64 v) noexcept {
+    if constexpr (std::endian::native == std::endian::big) v = bswap64(v);
+    std::memcpy(p, &v, 8);
+}
+
+inline Hash128 mul128(u64 a, u64 b) noexcept {
+#if defined(__SIZEOF_INT128__)
+    auto p = static_cast<unsigned __int128>(a) * b;
+    return {u64(p), u64(p >> 64)};
+#elif defined(_MSC_VER) && defined(_M_X64)
+    u64 hi;
+    u64 lo = _umul128(a, b, &hi);
+    return {lo, hi};
+#else
+    u64 lolo  = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+    u64 hilo  = (a >> 32) * (b & 0xFFFFFFFF);
+    u64 lohi  = (a & 0xFFFFFFFF) * (b >> 32);
+    u64 hihi  = (a >> 32) * (b >> 32);
+    u64 cross = (lolo >> 32) + (hilo & 0xFFFFFFFF) + lohi;
+    return {(cross << 32) | (lolo & 0xFFFFFFFF), (hilo >> 32) + (cross >> 32) + hihi};
+#endif
+}
+
+inline u64 fold64(u64 a, u64 b) noexcept {
+    Hash128 p = mul128(a, b);
+    return p.lo ^ p.hi;
+}
+
+inline u64 xs(u64 v, int s) noexcept { return v ^ (v >> s); }
+
+inline u64 avalanche(u64 h) noexcept {
+    return xs(xs(h, 37) * MX1, 32);
+}
+
+inline u64 avalanche64(u64 h) noexcept {
+    h = xs(h, 33) * P64_2;
+    h = xs(h, 29) * P64_3;
+    return xs(h, 32);
+}
+
+inline u64 rrmxmx(u64 h, u64 len) noexcept {
+    h ^= std::rotl(h, 49) ^ std::rotl(h, 24);
+    h *= MX2;
+    h ^= (h >> 35) + len;
+    h *= MX2;
+    return xs(h, 28);
+}
+
+inline u64 mix16(const u8* in, const u8* sec, u64 seed) noexcept {
+    return fold64(rd64(in) ^ (rd64(sec) + seed), rd64(in + 8) ^ (rd64(sec + 8) - seed));
+}
+
+inline void init_secret(u8* out, u64 seed) noexcept {
+    for (size_t i = 0; i < kSecretSize; i += 16) {
+        wr64(out + i,     rd64(kSecret + i)     + seed);
+        wr64(out + i + 8, rd64(kSecret + i + 8) - seed);
+    }
+}
+
+// ---- 0 .. 240 bytes : kSecret and the seed mixed in directly ----
+inline u64 short64(const u8* in, size_t len, u64 seed) noexcept {
+    const u8* s = kSecret;
+    if (len > 16) {
+        u64 acc = len * P64_1;
+        if (len <= 128) {
+            if (len > 32) {
+                if (len > 64) {
+                    if (len > 96) {
+                        acc += mix16(in + 48, s + 96, seed);
+                        acc += mix16(in + len - 64, s + 112, seed);
+                    }
+                    acc += mix16(in + 32, s + 64, seed);
+                    acc += mix16(in + len - 48, s + 80, seed);
+                }
+                acc += mix16(in + 16, s + 32, seed);
+                acc += mix16(in + len - 32, s + 48, seed);
+            }
+            acc += mix16(in, s, seed);
+            acc += mix16(in + len - 16, s + 16, seed);
+            return avalanche(acc);
+        }
+        for (size_t i = 0; i < 8; ++i) acc += mix16(in + 16 * i, s + 16 * i, seed);
+        u64 end = mix16(in + len - 16, s + 136 - 17, seed);
+        acc = avalanche(acc);
+        for (size_t i = 8; i < len / 16; ++i) end += mix16(in + 16 * i, s + 16 * (i - 8) + 3, seed);
+        return avalanche(acc + end);
+    }
+    if (len > 8) {
+        u64 lo  = rd64(in) ^ ((rd64(s + 24) ^ rd64(s + 32)) + seed);
+        u64 hi  = rd64(in + len - 8) ^ ((rd64(s + 40) ^ rd64(s + 48)) - seed);
+        return avalanche(len + bswap64(lo) + hi + fold64(lo, hi));
+    }
+    if (len >= 4) {
+        seed ^= u64(bswap32(u32(seed))) << 32;
+        u64 v = rd32(in + len - 4) + (u64(rd32(in)) << 32);
+        return rrmxmx(v ^ ((rd64(s + 8) ^ rd64(s + 16)) - seed), len);
+    }
+    if (len > 0) {
+        u32 c = (u32(in[0]) << 16) | (u32(in[len >> 1]) << 24) | in[len - 1] | (u32(len) << 8);
+        return avalanche64(c ^ ((rd32(s) ^ rd32(s + 4)) + seed));
+    }
+    return avalanche64(seed ^ rd64(s + 56) ^ rd64(s + 64));
+}
+
+inline Hash128 mix32(Hash128 acc, const u8* a, const u8* b, const u8* sec, u64 seed) noexcept {
+    acc.lo += mix16(a, sec, seed);
+    acc.lo ^= rd64(b) + rd64(b + 8);
+    acc.hi += mix16(b, sec + 16, seed);
+    acc.hi ^= rd64(a) + rd64(a + 8);
+    return acc;
+}
+
+inline Hash128 short128(const u8* in, size_t len, u64 seed) noexcept {
+    const u8* s = kSecret;
+    if (len > 16) {
+        Hash128 acc{len * P64_1, 0};
+        if (len <= 128) {
+            if (len > 32) {
+                if (len > 64) {
+                    if (len > 96) acc = mix32(acc, in + 48, in + len - 64, s + 96, seed);
+                    acc = mix32(acc, in + 32, in + len - 48, s + 64, seed);
+                }
+                acc = mix32(acc, in + 16, in + len - 32, s + 32, seed);
+            }
+            acc = mix32(acc, in, in + len - 16, s, seed);
+        } else {
+            for (size_t i = 32; i < 160; i += 32) acc = mix32(acc, in + i - 32, in + i - 16, s + i - 32, seed);
+            acc = {avalanche(acc.lo), avalanche(acc.hi)};
+            for (size_t i = 160; i <= len; i += 32)
+                acc = mix32(acc, in + i - 32, in + i - 16, s + 3 + i - 160, seed);
+            acc = mix32(acc, in + len - 16, in + len - 32, s + 136 - 17 - 16, 0 - seed);
+        }
+        u64 lo = acc.lo + acc.hi;
+        u64 hi = acc.lo * P64_1 + acc.hi * P64_4 + (len - seed) * P64_2;
+        return {avalanche(lo), 0 - avalanche(hi)};
+    }
+    if (len > 8) {
+        u64     lo = rd64(in);
+        u64     hi = rd64(in + len - 8);
+        Hash128 m  = mul128(lo ^ hi ^ ((rd64(s + 32) ^ rd64(s + 40)) - seed), P64_1);
+        m.lo += u64(len - 1) << 54;
+        hi   ^= (rd64(s + 48) ^ rd64(s + 56)) + seed;
+        m.hi += hi + (hi & 0xFFFFFFFF) * (P32_2 - 1);
+        m.lo ^= bswap64(m.hi);
+        Hash128 h = mul128(m.lo, P64_2);
+        h.hi += m.hi * P64_2;
+        return {avalanche(h.lo), avalanche(h.hi)};
+    }
+    if (len >= 4) {
+        seed ^= u64(bswap32(u32(seed))) << 32;
+        u64     v = rd32(in) + (u64(rd32(in + len - 4)) << 32);
+        Hash128 m = mul128(v ^ ((rd64(s + 16) ^ rd64(s + 24)) + seed), P64_1 + (len << 2));
+        m.hi += m.lo << 1;
+        m.lo ^= m.hi >> 3;
+        m.lo  = xs(xs(m.lo, 35) * MX2, 28);
+        return {m.lo, avalanche(m.hi)};
+    }
+    if (len > 0) {
+        u32 c  = (u32(in[0]) << 16) | (u32(in[len >> 1]) << 24) | in[len - 1] | (u32(len) << 8);
+        u32 ch = std::rotl(bswap32(c), 13);
+        return {avalanche64(c ^ ((rd32(s) ^ rd32(s + 4)) + seed)),
+                avalanche64(ch ^ ((rd32(s + 8) ^ rd32(s + 12)) - seed))};
+    }
+    return {avalanche64(seed ^ rd64(s + 64) ^ rd64(s + 72)),
+            avalanche64(seed ^ rd64(s + 80) ^ rd64(s + 88))};
+}
+
+// ---- long inputs : 8 lanes over 64 byte stripes, scrambled every block ----
+using acc_fn = void (*)(u64* acc, const u8* in, const u8* sec, size_t stripes) noexcept;
+
+inline void accumulate_scalar(u64* acc, const u8* in, const u8* sec, size_t stripes) noexcept {
+    for (size_t n = 0; n < stripes; ++n, in += kStripe, sec += 8) {
+        for (size_t i = 0; i < 8; ++i) {
+            u64 v = rd64(in + 8 * i);
+            u64 k = v ^ rd64(sec + 8 * i);
+            acc[i ^ 1] += v;
+            acc[i]     += (k & 0xFFFFFFFF) * (k >> 32);
+        }
+    }
+}
+
+#ifdef X_SIMD_X86
+inline void accumulate_sse2(u64* acc, const u8* in, const u8* sec, size_t stripes) noexcept {
+    __m128i a[4];
+    for (int i = 0; i < 4; ++i) a[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc) + i);
+    for (size_t n = 0; n < stripes; ++n, in += kStripe, sec += 8) {
+        for (int i = 0; i < 4; ++i) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in) + i);
+            __m128i k = _mm_xor_si128(v, _mm_loadu_si128(reinterpret_cast<const __m128i*>(sec) + i));
+            __m128i p = _mm_mul_epu32(k, _mm_shuffle_epi32(k, _MM_SHUFFLE(0, 3, 0, 1)));
+            a[i] = _mm_add_epi64(_mm_add_epi64(a[i], _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2))), p);
+        }
+    }
+    for (int i = 0; i < 4; ++i) _mm_storeu_si128(reinterpret_cast<__m128i*>(acc) + i, a[i]);
+}
+
+X_TARGET_AVX2
+inline void accumulate_avx2(u64* acc, const u8* in, const u8* sec, size_t stripes) noexcept {
+    auto    vin  = reinterpret_cast<const __m256i*>(in);
+    auto    vsec = reinterpret_cast<const __m256i*>(sec);
+    __m256i a0   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc));
+    __m256i a1   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc) + 1);
+    // a stripe is 2 vectors, the secret slides by 8 bytes per stripe
+    for (size_t n = 0; n < stripes; ++n, vin += 2, vsec = reinterpret_cast<const __m256i*>(sec += 8)) {
+        __m256i v0 = _mm256_loadu_si256(vin),     k0 = _mm256_xor_si256(v0, _mm256_loadu_si256(vsec));
+        __m256i v1 = _mm256_loadu_si256(vin + 1), k1 = _mm256_xor_si256(v1, _mm256_loadu_si256(vsec + 1));
+        a0 = _mm256_add_epi64(a0, _mm256_shuffle_epi32(v0, _MM_SHUFFLE(1, 0, 3, 2)));
+        a1 = _mm256_add_epi64(a1, _mm256_shuffle_epi32(v1, _MM_SHUFFLE(1, 0, 3, 2)));
+        a0 = _mm256_add_epi64(a0, _mm256_mul_epu32(k0, _mm256_srli_epi64(k0, 32)));
+        a1 = _mm256_add_epi64(a1, _mm256_mul_epu32(k1, _mm256_srli_epi64(k1, 32)));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc), a0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + 4), a1);
+}
+#endif
+
+inline acc_fn accumulate() noexcept {
+#ifdef X_SIMD_X86
+    return has_avx2() ? accumulate_avx2 : accumulate_sse2;
+#else
+    return accumulate_scalar;
+#endif
+}
+
+// once per 1 KiB block, not worth a vector version
+inline void scramble(u64* acc, const u8* sec) noexcept {
+    for (size_t i = 0; i < 8; ++i)
+        acc[i] = (xs(acc[i], 47) ^ rd64(sec + 8 * i)) * P32_1;
+}
+
+inline void init_acc(u64* acc) noexcept {
+    const u64 init[8] = {P32_3, P64_1, P64_2, P64_3, P64_4, P32_2, P64_5, P32_1};
+    std::memcpy(acc, init, sizeof(init));
+}
+
+inline u64 merge(const u64* acc, const u8* sec, u64 start) noexcept {
+    for (size_t i = 0; i < 4; ++i)
+        start += fold64(acc[2 * i] ^ rd64(sec + 16 * i), acc[2 * i + 1] ^ rd64(sec + 16 * i + 8));
+    return avalanche(start);
+}
+
+// stripes of one input, keeping track of where the current block stands
+inline const u8* consume(acc_fn f, u64* acc, size_t& done, const u8* in, size_t stripes, const u8* sec) noexcept {
+    while (stripes > 0) {
+        size_t n = std::min(stripes, kBlockStripes - done);
+        f(acc, in, sec + done * 8, n);
+        in      += n * kStripe;
+        stripes -= n;
+        done    += n;
+        if (done == kBlockStripes) {
+            scramble(acc, sec + kSecretSize - kStripe);
+            done = 0;
+        }
+    }
+    return in;
+}
+
+// acc after all of in (len > 240), last stripe included
+inline void long_acc(u64* acc, const u8* in, size_t len, const u8* sec) noexcept {
+    acc_fn f    = accumulate();
+    size_t done = 0;
+    init_acc(acc);
+    consume(f, acc, done, in, (len - 1) / kStripe, sec);
+    f(acc, in + len - kStripe, sec + kSecretSize - kStripe - 7, 1);
+}
+
+inline u64 long64(const u8* in, size_t len, u64 seed) noexcept {
+    alignas(64) u8  custom[kSecretSize];
+    alignas(64) u64 acc[8];
+    const u8* sec = kSecret;
+    if (seed != 0) {
+        init_secret(custom, seed);
+        sec = custom;
+    }
+    long_acc(acc, in, len, sec);
+    return merge(acc, sec + 11, len * P64_1);
+}
+
+inline Hash128 long128(const u8* in, size_t len, u64 seed) noexcept {
+    alignas(64) u8  custom[kSecretSize];
+    alignas(64) u64 acc[8];
+    const u8* sec = kSecret;
+    if (seed != 0) {
+        init_secret(custom, seed);
+        sec = custom;
+    }
+    long_acc(acc, in, len, sec);
+    return {merge(acc, sec + 11, len * P64_1), merge(acc, sec + kSecretSize - 64 - 11, ~(len * P64_2))};
+}
+
+} // namespace detail::xxh
+
+namespace detail::xxh {
+inline u64 hash64(const u8* p, size_t n, u64 seed) noexcept {
+    return n <= kMidMax ? short64(p, n, seed) : long64(p, n, seed);
+}
+
+inline Hash128 hash128(const u8* p, size_t n, u64 seed) noexcept {
+    return n <= kMidMax ? short128(p, n, seed) : long128(p, n, seed);
+}
+} // namespace detail::xxh
+
+inline u64 hash_bytes(cSView& s, u64 seed = 0) noexcept {
+    return detail::xxh::hash64(reinterpret_cast<const u8*>(s.data()), s.size(), seed);
+}
+
+inline u64 hash_bytes(std::span<const u8> b, u64 seed = 0) noexcept {
+    return detail::xxh::hash64(b.data(), b.size(), seed);
+}
+
+inline Hash128 hash_bytes128(cSView& s, u64 seed = 0) noexcept {
+    return detail::xxh::hash128(reinterpret_cast<const u8*>(s.data()), s.size(), seed);
+}
+
+inline Hash128 hash_bytes128(std::span<const u8> b, u64 seed = 0) noexcept {
+    return detail::xxh::hash128(b.data(), b.size(), seed);
+}
+
+// incremental XXH3 : update() in any pieces, digest() equals hash_bytes of
+// everything fed so far (and digest128() hash_bytes128)
+class Hasher {
+public:
+    explicit Hasher(u64 seed = 0) noexcept { reset(seed); }
+
+    void reset(u64 seed = 0) noexcept {
+        detail::xxh::init_acc(acc_);
+        detail::xxh::init_secret(secret_, seed);
+        seed_     = seed;
+        total_    = 0;
+        buffered_ = 0;
+        stripes_  = 0;
+    }
+
+    Hasher& update(std::span<const u8> b) noexcept {
+        using namespace detail::xxh;
+        const u8* p   = b.data();
+        size_t    n   = b.size();
+        const u8* end = p + n;
+        total_  += n;
+        if (n <= sizeof(buf_) - buffered_) {
+            if (n) std::memcpy(buf_ + buffered_, p, n);
+            buffered_ += n;
+            return *this;
+        }
+        // always keep some input back : the last stripe is hashed in digest()
+        acc_fn f = accumulate();
+        if (buffered_) {
+            size_t fill = sizeof(buf_) - buffered_;
+            std::memcpy(buf_ + buffered_, p, fill);
+            p += fill;
+            consume(f, acc_, stripes_, buf_, sizeof(buf_) / kStripe, secret_);
+            buffered_ = 0;
+        }
+        if (size_t(end - p) > sizeof(buf_)) {
+            p = consume(f, acc_, stripes_, p, size_t(end - p - 1) / kStripe, secret_);
+            std::memcpy(buf_ + sizeof(buf_) - kStripe, p - kStripe, kStripe);
+        }
+        std::memcpy(buf_, p, size_t(end - p));
+        buffered_ = size_t(end - p);
+        return *this;
+    }
+
+    Hasher& update(cSView& s) noexcept { return update({reinterpret_cast<const u8*>(s.data()), s.size()}); }
+
+    u64 digest() const noexcept {
+        using namespace detail::xxh;
+        if (total_ <= kMidMax) return short64(buf_, size_t(total_), seed_);
+        alignas(64) u64 acc[8];
+        finish(acc);
+        return merge(acc, secret_ + 11, total_ * P64_1);
+    }
+
+    Hash128 digest128() const noexcept {
+        using namespace detail::xxh;
+        if (total_ <= kMidMax) return short128(buf_, size_t(total_), seed_);
+        alignas(64) u64 acc[8];
+        finish(acc);
+        return {merge(acc, secret_ + 11, total_ * P64_1),
+                merge(acc, secret_ + kSecretSize - 64 - 11, ~(total_ * P64_2))};
+    }
+
+    u64 size() const noexcept { return total_; }
+
+private:
+    // acc with the buffered tail and last stripe folded in, state untouched
+    void finish(u64* acc) const noexcept {
+        using namespace detail::xxh;
+        std::memcpy(acc, acc_, sizeof(acc_));
+        acc_fn    f = accumulate();
+        u8        last[kStripe];
+        const u8* lp;
+        if (buffered_ >= kStripe) {
+            size_t done = stripes_;
+            consume(f, acc, done, buf_, (buffered_ - 1) / kStripe, secret_);
+            lp = buf_ + buffered_ - kStripe;
+        } else {
+            // wraps around : the tail of the previous buffer, then what is new
+            size_t back = kStripe - buffered_;
+            std::memcpy(last, buf_ + sizeof(buf_) - back, back);
+            std::memcpy(last + back, buf_, buffered_);
+            lp = last;
+        }
+        f(acc, lp, secret_ + kSecretSize - kStripe - 7, 1);
+    }
+
+    alignas(64) u64 acc_[8];
+    alignas(64) u8  secret_[detail::xxh::kSecretSize];
+    alignas(64) u8  buf_[256];
+    size_t          buffered_ = 0;
+    size_t          stripes_  = 0;  // into the current block
+    u64             total_    = 0;
+    u64             seed_     = 0;
+};
+
+namespace detail {
+inline constexpr auto crc32c_table = [] {
+    std::array<std::array<u32, 256>, 8> t{};
+    for (u32 i = 0; i < 256; ++i) {
+        u32 c = i;
+        for (int k = 0; k < 8; ++k) c = (c & 1) ? (c >> 1) ^ 0x82F63B78u : c >> 1;
+        t[0][i] = c;
+    }
+    for (u32 i = 0; i < 256; ++i)
+        for (size_t k = 1; k < 8; ++k) t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+    return t;
+}();
+
+// slicing by 8
+inline u32 crc32c_scalar(u32 crc, const u8* p, size_t n) noexcept {
+    const auto& t = crc32c_table;
+    for (; n >= 8; n -= 8, p += 8) {
+        u64 v = xxh::rd64(p) ^ crc;
+        crc = t[7][v & 0xFF] ^ t[6][(v >> 8) & 0xFF] ^ t[5][(v >> 16) & 0xFF] ^ t[4][(v >> 24) & 0xFF] ^
+              t[3][(v >> 32) & 0xFF] ^ t[2][(v >> 40) & 0xFF] ^ t[1][(v >> 48) & 0xFF] ^ t[0][v >> 56];
+    }
+    for (; n > 0; --n, ++p) crc = t[0][(crc ^ *p) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+#ifdef X_SIMD_X86
+X_TARGET_SSE42
+inline u32 crc32c_sse42(u32 crc, const u8* p, size_t n) noexcept {
+    u64 c = crc;
+    for (; n >= 8; n -= 8, p += 8) {
+        u64 v;
+        std::memcpy(&v, p, 8);
+        c = _mm_crc32_u64(c, v);
+    }
+    u32 c32 = u32(c);
+    for (; n > 0; --n, ++p) c32 = _mm_crc32_u8(c32, *p);
+    return c32;
+}
+#endif
+} // namespace detail
+
+// crc of data following crc, so crc32c(b, crc32c(a)) == crc32c(a + b)
+inline u32 crc32c(std::span<const u8> b, u32 crc = 0) noexcept {
+#ifdef X_SIMD_X86
+    if (detail::has_sse42()) return ~detail::crc32c_sse42(~crc, b.data(), b.size());
+#endif
+    return ~detail::crc32c_scalar(~crc, b.data(), b.size());
+}
+
+inline u32 crc32c(cSView& s, u32 crc = 0) noexcept {
+    return crc32c({reinterpret_cast<const u8*>(s.data()), s.size()}, crc);
+}
+
+struct HashOptions {
+    u64    seed    = 0;
+    size_t chunk   = 0;     // > 0 : tree mode over chunk byte leaves
+    u32    threads = 0;     // tree mode workers, 0 : hardware_concurrency
+};
+
+namespace detail {
+// tree mode : leaves are hash_bytes128(chunk, seed), hashed in parallel; the
+// root is hashed over the leaves (lo, hi as little endian u64), then the total
+// length and the chunk size (u64 le). depends on chunk, not on threads;
+// inputs of at most one chunk hash flat
+inline str hash_leaves(const u8* p, size_t n, const HashOptions& opt) {
+    size_t leaves = (n + opt.chunk - 1) / opt.chunk;
+    str    out(leaves * 16 + 16, '\0');
+    auto   dst = reinterpret_cast<u8*>(out.data());
+    parallel_for(leaves, 1, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            size_t  off = i * opt.chunk;
+            Hash128 h   = xxh::hash128(p + off, std::min(opt.chunk, n - off), opt.seed);
+            xxh::wr64(dst + 16 * i, h.lo);
+            xxh::wr64(dst + 16 * i + 8, h.hi);
+        }
+    }, opt.threads);
+    xxh::wr64(dst + leaves * 16, n);
+    xxh::wr64(dst + leaves * 16 + 8, opt.chunk);
+    return out;
+}
+} // namespace detail
+
+namespace detail {
+// hash_tree over input that arrives in pieces (pipes, /proc) : a leaf is
+// closed once chunk bytes are in and more follow, so a single leaf ends up
+// as the flat hash exactly like hash_tree
+class TreeHasher {
+public:
+    explicit TreeHasher(const HashOptions& opt) noexcept : opt_(opt), leaf_(opt.seed) {}
+
+    void update(cSView& s) {
+        if (opt_.chunk == 0) {
+            leaf_.update(s);
+            return;
+        }
+        for (size_t off = 0; off < s.size();) {
+            if (leaf_.size() == opt_.chunk) close_leaf();
+            size_t take = std::min<size_t>(opt_.chunk - size_t(leaf_.size()), s.size() - off);
+            leaf_.update(s.substr(off, take));
+            off += take;
+        }
+    }
+
+    u64 digest() {
+        if (leaves_.empty()) return leaf_.digest();
+        return hash_bytes(root(), opt_.seed);
+    }
+
+    Hash128 digest128() {
+        if (leaves_.empty()) return leaf_.digest128();
+        return hash_bytes128(root(), opt_.seed);
+    }
+
+private:
+    void close_leaf() {
+        Hash128 h = leaf_.digest128();
+        char    b[16];
+        xxh::wr64(reinterpret_cast<u8*>(b), h.lo);
+        xxh::wr64(reinterpret_cast<u8*>(b) + 8, h.hi);
+        leaves_.append(b, 16);
+        total_ += leaf_.size();
+        leaf_.reset(opt_.seed);
+    }
+
+    // leaves, total length, chunk : the layout of hash_leaves
+    cStr& root() {
+        close_leaf();
+        char b[16];
+        xxh::wr64(reinterpret_cast<u8*>(b), total_);
+        xxh::wr64(reinterpret_cast<u8*>(b) + 8, opt_.chunk);
+        leaves_.append(b, 16);
+        return leaves_;
+    }
+
+    HashOptions opt_;
+    Hasher      leaf_;
+    str         leaves_;
+    u64         total_ = 0;     // bytes in closed leaves
+};
+} // namespace detail
+
+inline u64 hash_tree(cSView& data, const HashOptions& opt) {
+    if (opt.chunk == 0 || data.size() <= opt.chunk) return hash_bytes(data, opt.seed);
+    return hash_bytes(detail::hash_leaves(reinterpret_cast<const u8*>(data.data()), data.size(), opt), opt.seed);
+}
+
+inline Hash128 hash_tree128(cSView& data, const HashOptions& opt) {
+    if (opt.chunk == 0 || data.size() <= opt.chunk) return hash_bytes128(data, opt.seed);
+    return hash_bytes128(detail::hash_leaves(reinterpret_cast<const u8*>(data.data()), data.size(), opt), opt.seed);
+}
+
+namespace detail {
+// regular files are mapped and hashed in one go (tree mode when asked);
+// anything else, and files that report no size (/proc), is streamed through
+// feed(piece, last). nullopt : missing or a directory
+template<typename R, typename Map, typename Feed>
+inline std::optional<R> hash_path(cStr& path, Map&& on_map, Feed&& feed) {
+    Stat st = stat(path);
+    if (!st.exists() || st.is_dir()) return std::nullopt;
+    if (st.is_file() && st.size > 0) {
+        MappedFile m;
+        if (m.open(path, {.advice = MapAdvice::Sequential})) return on_map(m.view());
+    }
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return std::nullopt;
+    char buf[64 * 1024];
+    while (file.read(buf, sizeof(buf)) || file.gcount() > 0)
+        feed(sView(buf, size_t(file.gcount())), false);
+    return feed(sView{}, true);
+}
+} // namespace detail
+
+// same value whether the file is mapped or streamed, tree mode included
+inline std::optional<u64> hash_file(cStr& path, const HashOptions& opt = HashOptions{}) {
+    detail::TreeHasher h(opt);
+    return detail::hash_path<u64>(path, [&](cSView& v) { return hash_tree(v, opt); },
+                                  [&](cSView& v, bool last) { return h.update(v), last ? h.digest() : 0; });
+}
+
+inline std::optional<Hash128> hash_file128(cStr& path, const HashOptions& opt = HashOptions{}) {
+    detail::TreeHasher h(opt);
+    return detail::hash_path<Hash128>(path, [&](cSView& v) { return hash_tree128(v, opt); },
+                                      [&](cSView& v, bool last) { return h.update(v), last ? h.digest128() : Hash128{}; });
+}
+
+inline std::optional<u32> crc32c_file(cStr& path) {
+    u32 crc = 0;
+    return detail::hash_path<u32>(path, [](cSView& v) { return crc32c(v); },
+                                  [&](cSView& v, bool) { return crc = crc32c(v, crc); });
+}
+
+// ----------------------- CsvReader -----------------------
+// streaming csv/tsv reader : fixed-size chunks, quoted fields (rfc 4180),
+// memory bounded by chunk size + longest row
+// fields are views into the reader's buffer, valid until the next row
+//
+// x::CsvReader csv("data.csv");
+// while (csv.next()) { auto id = csv.get<i64>(0); auto name = csv[1]; }
+struct CsvOptions {
+    char   delimiter        = ',';
+    char   quote            = '"';
+    size_t chunk_size       = 1 << 20;
+    bool   has_header       = false;
+    bool   skip_empty_lines = true;
+};
+
+class CsvReader {
+public:
+    using Options = CsvOptions;
+
+    explicit CsvReader(cStr& path) : CsvReader(path, Options{}) {}
+
+    CsvReader(cStr& path, const Options& opt) : opt_(opt) {
+        file_.open(path, std::ios::binary);
+        open_ = file_.is_open();
+        init();
+    }
+
+    // stream from memory, data must outlive the reader
+    static CsvReader from_buffer(cSView& data, const Options& opt = {}) {
+        return CsvReader(InMemory{}, data, opt);
+    }
+
+    CsvReader(CsvReader&&) = default;
+    CsvReader& operator=(CsvReader&&) = default;
+
+    // advance to the next row, false at the end
+    bool next() {
+        while (read_row()) {
+            ++rows_;
+            if (opt_.skip_empty_lines && fields_.size() == 1 && fields_[0].empty())
+                continue;
+            return true;
+        }
+        fields_.clear();
+        return false;
+    }
+
+    bool   is_open() const noexcept { return open_;          }
+    size_t size()    const noexcept { return fields_.size(); }
+    // rows consumed so far, header and skipped empty lines included
+    size_t rows()    const noexcept { return rows_;          }
+
+    std::span<const sView> row() const noexcept { return fields_; }
+
+    // empty view for a missing column
+    sView operator[](size_t i) const noexcept {
+        return i < fields_.size() ? fields_[i] : sView{};
+    }
+
+    template<typename T>
+    std::optional<T> get(size_t i) const noexcept {
+        if (i >= fields_.size()) return std::nullopt;
+        return parse<T>(fields_[i]);
+    }
+
+    template<typename T>
+    std::optional<T> get(cSView& column) const noexcept {
+        size_t i = index(column);
+        return i == sView::npos ? std::nullopt : get<T>(i);
+    }
+
+    const _vec<str>& header() const noexcept { return header_; }
+
+    // column index by header name, npos if unknown
+    size_t index(cSView& column) const noexcept {
+        for (size_t i = 0; i < header_.size(); ++i)
+            if (header_[i] == column) return i;
+        return sView::npos;
+    }
+
+    // for (auto row : csv) { row[0] ... }
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = std::span<const sView>;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = std::span<const sView>;
+
+        iterator() = default;
+        explicit iterator(CsvReader* r) : r_(r) { ++*this; }
+
+        reference operator*() const noexcept { return r_->row(); }
+        iterator& operator++() {
+            if (!r_->next()) r_ = _nul;
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+        bool operator==(const iterator& other) const noexcept { return r_ == other.r_; }
+
+    private:
+        CsvReader* r_ = _nul;
+    };
+
+    iterator begin() { return iterator(this); }
+    iterator end()   { return {}; }
+
+private:
+    // tagged so a literal path never also matches the buffer constructor
+    struct InMemory {};
+
+    CsvReader(InMemory, cSView& data, const Options& opt) : opt_(opt), mem_(data), open_(true) {
+        init();
+    }
+
+    void init() {
+        buf_.resize(std::max<size_t>(opt_.chunk_size, 64));
+        if (opt_.has_header && next()) {
+            for (auto f : fields_)
+                header_.emplace_back(f);
+        }
+    }
+
+    // move the unread tail to the front, grow if one row fills the buffer, read more
+    bool refill() {
+        if (eof_) return false;
+        if (pos_ > 0) {
+            std::memmove(buf_.data(), buf_.data() + pos_, end_ - pos_);
+            end_ -= pos_;
+            pos_  = 0;
+        }
+        if (end_ == buf_.size())
+            buf_.resize(buf_.size() * 2);
+        size_t room = buf_.size() - end_, n = 0;
+        if (file_.is_open()) {
+            file_.read(buf_.data() + end_, std::streamsize(room));
+            n = size_t(file_.gcount());
+        } else {
+            n = std::min(room, mem_.size() - mem_pos_);
+            std::memcpy(buf_.data() + end_, mem_.data() + mem_pos_, n);
+            mem_pos_ += n;
+        }
+        end_ += n;
+        if (n < room) eof_ = true;
+        return n > 0;
+    }
+
+    // end of the row starting at pos_ (index of '\n' or end_), npos if the
+    // buffer ends first; sets quoted when the row contains a quote
+    size_t row_end(bool& quoted) const noexcept {
+        sView rest(buf_.data() + pos_, end_ - pos_);
+        size_t nl = find_byte(rest, '\n');
+        size_t q  = find_byte(rest.substr(0, nl), opt_.quote);
+        quoted = q != sView::npos;
+        if (!quoted)
+            return nl != sView::npos ? pos_ + nl : eof_ ? end_ : sView::npos;
+        bool in_quotes = false;
+        for (size_t i = q; i < rest.size(); ++i) {
+            if (rest[i] == opt_.quote) in_quotes = !in_quotes;
+            else if (rest[i] == '\n' && !in_quotes) return pos_ + i;
+        }
+        return eof_ ? end_ : sView::npos;
+    }
+
+    bool read_row() {
+        fields_.clear();
+        bool   quoted = false;
+        size_t e      = sView::npos;
+        while (pos_ == end_ || (e = row_end(quoted)) == sView::npos) {
+            if (!refill()) {
+                if (pos_ == end_) return false;
+                e = row_end(quoted);
+                break;
+            }
+        }
+        char* b    = buf_.data() + pos_;
+        char* last = buf_.data() + e;
+        pos_ = e < end_ ? e + 1 : e;
+        if (last > b && last[-1] == '\r') --last;
+        quoted ? split_quoted(b, last) : split_plain(b, last);
+        return true;
+    }
+
+    void split_plain(char* b, char* e) {
+        sView line(b, size_t(e - b));
+        size_t start = 0;
+        for (size_t d; (d = find_byte(line, opt_.delimiter, start)) != sView::npos; start = d + 1)
+            fields_.push_back(line.substr(start, d - start));
+        fields_.push_back(line.substr(start));
+    }
+
+    // unescape quoted fields in place, the text only ever shrinks
+    void split_quoted(char* p, char* e) {
+        const char q = opt_.quote, d = opt_.delimiter;
+        for (;;) {
+            char* field = p;
+            char* w     = p;
+            if (p < e && *p == q) {
+                for (++p; p < e; ) {
+                    if (*p != q) *w++ = *p++;
+                    else if (p + 1 < e && p[1] == q) { *w++ = q; p += 2; }
+                    else { ++p; break; }
+                }
+            }
+            while (p < e && *p != d) *w++ = *p++;   // unquoted, or text after a closing quote
+            fields_.emplace_back(field, size_t(w - field));
+            if (p >= e) break;
+            ++p;
+        }
+    }
+
+    Options         opt_;
+    std::ifstream   file_;
+    sView           mem_;
+    size_t          mem_pos_ = 0;
+    bool            open_    = false;
+    bool            eof_     = false;
+    _vec<char>      buf_;
+    size_t          pos_     = 0;   // unread data is buf_[pos_, end_)
+    size_t          end_     = 0;
+    size_t          rows_    = 0;
+    _vec<sView>     fields_;
+    _vec<str>       header_;
+};
+
+// ----------------------- LineReader -----------------------
+// streaming line reader : two chunk buffers, the next chunk is read in the
+// background while lines of the current one are handed out
+// "\n" and "\r\n" both end a line; a last line without newline is kept
+// lines are views into the reader's buffers, valid until the next line
+//
+// for (sView line : x::read_lines("app.log")) ...
+// x::LineReader r("app.log", 4 << 20);  while (r.next()) use(r.line());
+class LineReader {
+public:
+    static constexpr size_t kAlign = 4096;
+
+    explicit LineReader(cStr& path, size_t chunk_size = 1 << 20)
+        : file_(std::make_unique<std::ifstream>(path, std::ios::binary)),
+          chunk_((std::max(chunk_size, kAlign) + kAlign - 1) / kAlign * kAlign) {
+        open_ = file_->is_open();
+        if (!open_) {
+            eof_ = true;
+            return;
+        }
+        read_ahead();
+    }
+
+    ~LineReader() { wait(); }
+
+    // the source is left at its end, like a reader of a missing file
+    LineReader(LineReader&& other) noexcept { *this = std::move(other); }
+    LineReader& operator=(LineReader&& other) noexcept {
+        if (this != &other) {
+            wait();
+            pending_ = std::move(other.pending_);
+            file_    = std::move(other.file_);
+            for (int i = 0; i < 2; ++i) {
+                buf_[i] = std::move(other.buf_[i]);
+                cap_[i] = other.cap_[i];
+                off_[i] = other.off_[i];
+            }
+            spill_ = std::move(other.spill_);
+            chunk_ = other.chunk_;  slack_ = other.slack_;  back_ = other.back_;
+            data_  = other.data_;   len_   = other.len_;    pos_  = other.pos_;
+            line_  = other.line_;   lines_ = other.lines_;
+            open_  = other.open_;   eof_   = other.eof_;
+            other.data_ = "";
+            other.len_  = other.pos_ = 0;
+            other.line_ = {};
+            other.open_ = false;
+            other.eof_  = true;
+        }
+        return *this;
+    }
+
+    // advance to the next line, false at the end
+    bool next() {
+        for (;;) {
+            sView rest(data_ + pos_, len_ - pos_);
+            size_t nl = find_byte(rest, '\n');
+            if (nl != sView::npos) {
+                take(rest.substr(0, nl), nl + 1);
+                return true;
+            }
+            if (eof_) {
+                if (rest.empty()) {
+                    line_ = {};
+                    return false;
+                }
+                take(rest, rest.size());
+                return true;
+            }
+            refill();
+        }
+    }
+
+    bool   is_open() const noexcept { return open_;  }
+    sView  line()    const noexcept { return line_;  }
+    // lines handed out so far
+    size_t lines()   const noexcept { return lines_; }
+
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = sView;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = sView;
+
+        iterator() = default;
+        explicit iterator(LineReader* r) : r_(r) { ++*this; }
+
+        reference operator*() const noexcept { return r_->line(); }
+        iterator& operator++() {
+            if (!r_->next()) r_ = _nul;
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+        bool operator==(const iterator& other) const noexcept { return r_ == other.r_; }
+
+    private:
+        LineReader* r_ = _nul;
+    };
+
+    iterator begin() { return iterator(this); }
+    iterator end()   { return {}; }
+
+private:
+    struct AlignedDelete {
+        void operator()(char* p) const noexcept { ::operator delete[](p, std::align_val_t(kAlign)); }
+    };
+    using Buffer = std::unique_ptr<char[], AlignedDelete>;
+
+    void take(sView l, size_t used) noexcept {
+        if (!l.empty() && l.back() == '\r') l.remove_suffix(1);
+        line_ = l;
+        pos_ += used;
+        ++lines_;
+    }
+
+    void wait() {
+        if (pending_.valid()) pending_.wait();
+    }
+
+    // start reading the next chunk into buf_[back_], after slack_ bytes
+    // kept free in front for the unfinished line of the current chunk
+    void read_ahead() {
+        int b = back_;
+        if (cap_[b] < slack_ + chunk_) {
+            cap_[b] = slack_ + chunk_;
+            buf_[b] = Buffer(static_cast<char*>(::operator new[](cap_[b], std::align_val_t(kAlign))));
+        }
+        off_[b] = slack_;
+        std::ifstream* f = file_.get();
+        char*          p = buf_[b].get() + slack_;
+        size_t         n = chunk_;
+        pending_ = std::async(std::launch::async, [f, p, n] {
+            f->read(p, std::streamsize(n));
+            return size_t(f->gcount());
+        });
+    }
+
+    // swap in the chunk read in the background, unfinished line in front
+    void refill() {
+        sView  carry(data_ + pos_, len_ - pos_);
+        size_t n = pending_.get();
+        if (n == 0) {
+            eof_ = true;
+            return;
+        }
+        int   b   = back_;
+        char* dst = buf_[b].get() + off_[b];
+        if (carry.size() <= off_[b]) {
+            std::memcpy(dst - carry.size(), carry.data(), carry.size());
+            data_ = dst - carry.size();
+            len_  = carry.size() + n;
+        } else {
+            // a line longer than the slack : glue it in spill_, widen the slack
+            spill_.assign(carry);
+            spill_.append(dst, n);
+            data_  = spill_.data();
+            len_   = spill_.size();
+            slack_ = (carry.size() * 2 + kAlign - 1) / kAlign * kAlign;
+        }
+        pos_  = 0;
+        back_ = 1 - b;
+        if (n < chunk_) eof_ = true;
+        else read_ahead();
+    }
+
+    std::future<size_t>             pending_;
+    std::unique_ptr<std::ifstream>  file_;
+    Buffer                          buf_[2];
+    size_t                          cap_[2] = {0, 0};
+    size_t                          off_[2] = {0, 0};
+    str                             spill_;
+    size_t                          chunk_  = 0;
+    size_t                          slack_  = 64 * 1024;
+    int                             back_   = 0;
+    const char*                     data_   = "";
+    size_t                          len_    = 0;
+    size_t                          pos_    = 0;
+    sView                           line_;
+    size_t                          lines_  = 0;
+    bool                            open_   = false;
+    bool                            eof_    = false;
+};
+
+// lines of a file with memory bounded by two chunks + the longest line
+inline LineReader read_lines(cStr& path, size_t chunk_size = 1 << 20) {
+    return LineReader(path, chunk_size);
+}
+
+// ----------------------- utility functions -----------------------
+
+inline u64 id_thread() noexcept{
+    std::hash<std::thread::id> hasher;
+    return hasher(std::this_thread::get_id());
+}
+
+inline void sleep(cU64& milliseconds) noexcept {
+    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+inline str current_time(cStr& format = "%Y-%m-%d %H:%M:%S") noexcept {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::tm tm = *std::localtime(&time);
+    std::stringstream ss;
+    ss << std::put_time(&tm, format.c_str());
+    return ss.str();
+}
+
+// steady_clock ticks, in the implementation's units; timestamp_ns and
+// friends below have explicit units and are cheaper to read
+inline u64 timestamp() noexcept {
+    return std::chrono::steady_clock::now().
+            time_since_epoch().count();
+}
+
+namespace detail {
+// ns from the os monotonic clock, unslewed where the os has a raw clock
+inline u64 os_clock_ns() noexcept {
+#ifdef CLOCK_MONOTONIC_RAW
+    timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return u64(ts.tv_sec) * 1000000000 + u64(ts.tv_nsec);
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+#ifdef X_TSC
+// the tsc ticks at a constant rate whatever the p-state / c-state
+inline bool cpu_has_invariant_tsc() noexcept {
+#ifdef _MSC_VER
+    int r[4];
+    __cpuid(r, int(0x80000000));
+    if (u32(r[0]) < 0x80000007) return false;
+    __cpuid(r, int(0x80000007));
+    return (r[3] & (1 << 8)) != 0;
+#else
+    unsigned a, b, c, d;
+    if (!__get_cpuid(0x80000007, &a, &b, &c, &d)) return false;
+    return (d & (1 << 8)) != 0;
+#endif
+}
+
+inline bool has_invariant_tsc() noexcept {
+    static const bool v = cpu_has_invariant_tsc();
+    return v;
+}
+#endif
+
+// tsc -> ns : ns = base_ns + (c - base_cycles) * mult >> 32. the anchor is
+// taken at static init; once 10ms have passed the next read calibrates mult
+// (reads use the os clock until then, none of them blocks), and about every
+// second a read re-anchors against the os clock with mult fitted since
+// startup, so timestamps do not drift away from it
+class CycleClock {
+public:
+    struct Params {
+        u64 base_cycles = 0;
+        u64 base_ns     = 0;
+        u64 mult        = 0;    // ns per cycle, 32.32 fixed point; 0 : not calibrated
+        u64 period      = 0;    // cycles between re-anchors
+    };
+
+    CycleClock() noexcept {
+#ifdef X_TSC
+        if (!has_invariant_tsc()) return;
+        auto [c, n] = sample();
+        c0_ = c;
+        n0_ = n;
+        started_.store(true, std::memory_order_release);
+#endif
+    }
+
+    static u64 to_ns(u64 c, u64 mult) noexcept {
+        Hash128 m = xxh::mul128(c, mult);
+        return (m.hi << 32) | (m.lo >> 32);
+    }
+
+#ifdef X_TSC
+    // false : not calibrated yet, use the os clock
+    bool now_ns(u64& ns) noexcept {
+        if (!started_.load(std::memory_order_acquire)) return false;
+        Params p;
+        if (!read(p)) {
+            if (os_clock_ns() - n0_ >= kWarmup) update(false);
+            return false;
+        }
+        u64 c = __rdtsc();
+        if (i64(c - p.base_cycles) >= i64(p.period)) update(false);
+        // another core's tsc may read slightly behind the anchoring one
+        ns = p.base_ns + (i64(c - p.base_cycles) > 0 ? to_ns(c - p.base_cycles, p.mult) : 0);
+        return true;
+    }
+#endif
+
+    // mult, calibrating first if needed (waits out the 10ms after startup)
+    u64 mult() noexcept {
+#ifdef X_TSC
+        if (started_.load(std::memory_order_acquire)) {
+            calibrate();
+            Params p;
+            read(p);
+            return p.mult;
+        }
+#endif
+        return u64(1) << 32;
+    }
+
+    void calibrate() noexcept {
+#ifdef X_TSC
+        if (!started_.load(std::memory_order_acquire)) return;
+        Params p;
+        while (!read(p)) {
+            u64 since = os_clock_ns() - n0_;
+            if (since < kWarmup) std::this_thread::sleep_for(std::chrono::nanoseconds(kWarmup - since));
+            update(true);
+        }
+#endif
+    }
+
+private:
+#ifdef X_TSC
+    static constexpr u64 kWarmup = 10'000'000;     // ns before the first calibration
+
+    // (cycles, ns) from the tightest of a few bracketed reads
+    static std::pair<u64, u64> sample() noexcept {
+        u64 best = ~u64(0), c = 0, n = 0;
+        for (int i = 0; i < 8; ++i) {
+            u64 a = __rdtsc();
+            u64 t = os_clock_ns();
+            u64 b = __rdtsc();
+            if (b - a < best) {
+                best = b - a;
+                c    = a + (b - a) / 2;
+                n    = t;
+            }
+        }
+        return {c, n};
+    }
+
+    // seqlock read, false while not calibrated
+    bool read(Params& p) const noexcept {
+        for (;;) {
+            u64 s = seq_.load(std::memory_order_acquire);
+            if (s & 1) continue;
+            p.base_cycles = base_cycles_.load(std::memory_order_relaxed);
+            p.base_ns     = base_ns_.load(std::memory_order_relaxed);
+            p.mult        = mult_.load(std::memory_order_relaxed);
+            p.period      = period_.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == s) return p.mult != 0;
+        }
+    }
+
+    // one thread at a time (others skip it, or spin when it must happen)
+    void update(bool wait) noexcept {
+        while (busy_.exchange(true, std::memory_order_acquire))
+            if (!wait) return;
+        Params cur;
+        bool   have = read(cur);
+        // another thread re-anchored meanwhile
+        if (!wait && have && i64(__rdtsc() - cur.base_cycles) < i64(cur.period)) {
+            busy_.store(false, std::memory_order_release);
+            return;
+        }
+        auto [c, n] = sample();
+        if (have || n - n0_ >= kWarmup) {
+            Params p;
+            p.mult        = std::max<u64>(1, u64(f64(n - n0_) / f64(c - c0_) * 0x1.0p32));
+            p.period      = u64(1e9 * 0x1.0p32 / f64(p.mult));
+            p.base_cycles = c;
+            // never step back from what the previous anchor already returned
+            p.base_ns = have ? std::max(n, cur.base_ns + (i64(c - cur.base_cycles) > 0 ? to_ns(c - cur.base_cycles, cur.mult) : 0))
+                             : n;
+            u64 s = seq_.load(std::memory_order_relaxed);
+            seq_.store(s + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            base_cycles_.store(p.base_cycles, std::memory_order_relaxed);
+            base_ns_.store(p.base_ns, std::memory_order_relaxed);
+            mult_.store(p.mult, std::memory_order_relaxed);
+            period_.store(p.period, std::memory_order_relaxed);
+            seq_.store(s + 2, std::memory_order_release);
+        }
+        busy_.store(false, std::memory_order_release);
+    }
+
+    u64                 c0_ = 0;            // startup anchor
+    u64                 n0_ = 0;
+    std::atomic<bool>   started_{false};
+    std::atomic<bool>   busy_{false};
+    std::atomic<u64>    seq_{0};
+    std::atomic<u64>    base_cycles_{0};
+    std::atomic<u64>    base_ns_{0};
+    std::atomic<u64>    mult_{0};
+    std::atomic<u64>    period_{0};
+#endif
+};
+
+// anchored during static init, see CycleClock
+inline CycleClock cycle_clock_;
+
+inline CycleClock& cycle_clock() noexcept { return cycle_clock_; }
+} // namespace detail
+
+// raw counter for latency stamps : tsc cycles when the cpu has an invariant
+// tsc, else os clock ns. only differences mean anything, see cycles_to_ns
+//
+// u64 c0 = x::cycles();
+// work();
+// u64 ns = x::cycles_to_ns(x::cycles() - c0);
+inline u64 cycles() noexcept {
+#ifdef X_TSC
+    if (detail::has_invariant_tsc()) return __rdtsc();
+#endif
+    return detail::os_clock_ns();
+}
+
+// finish the cycles -> ns calibration now; it otherwise happens on the first
+// read 10ms or more after startup. blocks for what is left of those 10ms
+inline void calibrate_clock() noexcept { detail::cycle_clock().calibrate(); }
+
+// a cycles() difference in ns (calibrates first if needed, see calibrate_clock)
+inline u64 cycles_to_ns(u64 c) noexcept {
+    return detail::CycleClock::to_ns(c, detail::cycle_clock().mult());
+}
+
+inline f64 cycles_per_ns() noexcept { return 0x1.0p32 / f64(detail::cycle_clock().mult()); }
+
+// monotonic ns since an unspecified start : tsc based once calibrated, the
+// os clock (CLOCK_MONOTONIC_RAW where there is one) before that and without
+// an invariant tsc. never blocks
+inline u64 timestamp_ns() noexcept {
+#ifdef X_TSC
+    u64 ns;
+    if (detail::cycle_clock().now_ns(ns)) return ns;
+#endif
+    return detail::os_clock_ns();
+}
+
+inline u64 timestamp_us() noexcept { return timestamp_ns() / 1000; }
+
+inline u64 timestamp_ms() noexcept { return timestamp_ns() / 1000000; }
+
+template<typename T>
+inline T clamp(T value, T min, T max) noexcept {
+    return (value < min) ? min : (value > max) ? max : value;
+}
+
+// ----------------------- random -----------------------
+// xoshiro256** engines, one per thread : no locking, 32 bytes of state,
+// seeded from std::random_device on first use. seed_rand(s) makes the calling
+// thread's stream reproducible (same seed + same calls : same values)
+// bounded integers use Lemire's multiply-shift with exact rejection, no
+// modulo bias and no distribution object per call
+//
+// x::seed_rand(42);
+// i32 die = x::rand_int(1, 6);
+// x::rand_fill(std::span(samples), 0, 99);     // bulk, 8 values per avx2 step
+class Rng {
+public:
+    using result_type = u64;
+
+    static constexpr u64 min() noexcept { return 0; }
+    static constexpr u64 max() noexcept { return ~u64(0); }
+
+    explicit Rng(u64 seed = 0) noexcept { this->seed(seed); }
+
+    // the state is expanded from seed with splitmix64, never all zero
+    void seed(u64 s) noexcept {
+        for (auto& w : s_) w = splitmix(s);
+    }
+
+    u64 operator()() noexcept {
+        u64 r = std::rotl(s_[1] * 5, 7) * 9;
+        u64 t = s_[1] << 17;
+        s_[2] ^= s_[0];
+        s_[3] ^= s_[1];
+        s_[1] ^= s_[2];
+        s_[0] ^= s_[3];
+        s_[2] ^= t;
+        s_[3]  = std::rotl(s_[3], 45);
+        return r;
+    }
+
+    // uniform in [0, n), n > 0
+    u64 below(u64 n) noexcept {
+        Hash128 m = detail::xxh::mul128((*this)(), n);
+        if (m.lo < n) {
+            u64 t = (0 - n) % n;
+            while (m.lo < t) m = detail::xxh::mul128((*this)(), n);
+        }
+        return m.hi;
+    }
+
+    // uniform in [0, n), n > 0, from the high half of one output
+    u32 below32(u32 n) noexcept {
+        u64 m = u64((*this)() >> 32) * n;
+        if (u32(m) < n) {
+            u32 t = (0 - n) % n;
+            while (u32(m) < t) m = u64((*this)() >> 32) * n;
+        }
+        return u32(m >> 32);
+    }
+
+    // uniform in [lo, hi]
+    i64 range(i64 lo, i64 hi) noexcept {
+        if (hi < lo) std::swap(lo, hi);
+        u64 span = u64(hi) - u64(lo) + 1;
+        return i64(u64(lo) + (span == 0 ? (*this)() : below(span)));
+    }
+
+    // uniform in [0, 1), 53 bits
+    f64 uniform() noexcept { return f64((*this)() >> 11) * 0x1.0p-53; }
+
+    // advance 2^128 steps : non-overlapping streams for parallel workers
+    void jump() noexcept {
+        static constexpr u64 k[] = {0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+        u64 s[4] = {};
+        for (u64 j : k) {
+            for (int b = 0; b < 64; ++b) {
+                if (j & (u64(1) << b))
+                    for (int i = 0; i < 4; ++i) s[i] ^= s_[i];
+                (*this)();
+            }
+        }
+        std::memcpy(s_, s, sizeof(s));
+    }
+
+    static u64 splitmix(u64& x) noexcept {
+        u64 z = (x += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+
+private:
+    u64 s_[4];
+};
+
+namespace detail {
+inline u64 rand_entropy() noexcept {
+    u64 s = u64(std::chrono::steady_clock::now().time_since_epoch().count()) ^ (id_thread() << 1);
+    try {
+        std::random_device rd;
+        s ^= (u64(rd()) << 32) ^ rd();
+    } catch (...) {}
+    return s;
+}
+
+// the thread's engine plus 4 interleaved xoshiro256** lanes for bulk fills,
+// state laid out word-major so a word of all lanes is one avx2 register
+struct RandState {
+    Rng                 one;
+    alignas(32) u64     lanes[4][4];
+
+    RandState() noexcept { seed(rand_entropy()); }
+
+    void seed(u64 s) noexcept {
+        one.seed(s);
+        u64 x = s ^ 0x6a09e667f3bcc909;
+        for (auto& w : lanes)
+            for (auto& v : w) v = Rng::splitmix(x);
+    }
+
+    // one step of every lane (the avx2 path computes the same values)
+    void step(u64* out) noexcept {
+        auto& [s0, s1, s2, s3] = lanes;
+        for (int k = 0; k < 4; ++k) {
+            out[k] = std::rotl(s1[k] * 5, 7) * 9;
+            u64 t  = s1[k] << 17;
+            s2[k] ^= s0[k];
+            s3[k] ^= s1[k];
+            s1[k] ^= s2[k];
+            s0[k] ^= s3[k];
+            s2[k] ^= t;
+            s3[k]  = std::rotl(s3[k], 45);
+        }
+    }
+};
+
+inline RandState& rand_state() noexcept {
+    thread_local RandState st;
+    return st;
+}
+
+// bounded ints from the 8 u32 halves of a step (low half of lane 0 first),
+// rejected candidates are skipped; returns how many were stored
+inline size_t rand_keep(const u32* c, u64 span, u32 t, i32 lo, i32* out, size_t room) noexcept {
+    size_t k = 0;
+    for (size_t i = 0; i < 8 && k < room; ++i) {
+        u64 m = c[i] * span;
+        if (u32(m) < t) continue;
+        out[k++] = i32(u32(lo) + u32(m >> 32));
+    }
+    return k;
+}
+
+inline void rand_halves(const u64* v, u32* c) noexcept {
+    for (int k = 0; k < 4; ++k) {
+        c[2 * k]     = u32(v[k]);
+        c[2 * k + 1] = u32(v[k] >> 32);
+    }
+}
+
+// [0, 1) from the top 52 bits : 1.m - 1
+inline f64 rand_unit52(u64 v) noexcept {
+    return std::bit_cast<f64>((v >> 12) | 0x3ff0000000000000) - 1.0;
+}
+
+// lo + u * (hi - lo) for u in [0, 1), kept off hi when the product rounds up
+// to it : [2, 3) would give 3.0 for u = 1 - 2^-52
+inline f64 rand_scale(f64 u, f64 lo, f64 hi) noexcept {
+    f64 r = lo + u * (hi - lo);
+    return r != hi ? r : std::nextafter(hi, lo);
+}
+
+#ifdef X_SIMD_X86
+template<int K>
+X_TARGET_AVX2
+inline __m256i rotl64x4(__m256i v) noexcept {
+    return _mm256_or_si256(_mm256_slli_epi64(v, K), _mm256_srli_epi64(v, 64 - K));
+}
+
+X_TARGET_AVX2
+inline __m256i rand_step_avx2(__m256i* s) noexcept {
+    __m256i x5 = _mm256_add_epi64(_mm256_slli_epi64(s[1], 2), s[1]);
+    __m256i r  = rotl64x4<7>(x5);
+    r          = _mm256_add_epi64(_mm256_slli_epi64(r, 3), r);
+    __m256i t  = _mm256_slli_epi64(s[1], 17);
+    s[2] = _mm256_xor_si256(s[2], s[0]);
+    s[3] = _mm256_xor_si256(s[3], s[1]);
+    s[1] = _mm256_xor_si256(s[1], s[2]);
+    s[0] = _mm256_xor_si256(s[0], s[3]);
+    s[2] = _mm256_xor_si256(s[2], t);
+    s[3] = rotl64x4<45>(s[3]);
+    return r;
+}
+
+// whole steps while at least 8 slots are left, returns how many were filled
+X_TARGET_AVX2
+inline size_t rand_fill_avx2(RandState& st, i32* out, size_t n, i32 lo, u64 span, u32 t) noexcept {
+    __m256i s[4];
+    for (int i = 0; i < 4; ++i) s[i] = _mm256_load_si256(reinterpret_cast<const __m256i*>(st.lanes[i]));
+    const __m256i vlo   = _mm256_set1_epi32(lo);
+    const __m256i vspan = _mm256_set1_epi64x(i64(span));
+    const __m256i vt    = _mm256_set1_epi32(i32(t ^ 0x80000000u));
+    const __m256i sign  = _mm256_set1_epi32(i32(0x80000000u));
+    const __m256i lo32  = _mm256_set1_epi64x(0xffffffff);
+    const bool    full  = span == (u64(1) << 32);
+    size_t done = 0;
+    while (n - done >= 8) {
+        __m256i v = rand_step_avx2(s);
+        if (full) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + done), _mm256_add_epi32(v, vlo));
+            done += 8;
+            continue;
+        }
+        __m256i me  = _mm256_mul_epu32(v, vspan);
+        __m256i mo  = _mm256_mul_epu32(_mm256_srli_epi64(v, 32), vspan);
+        __m256i hi  = _mm256_or_si256(_mm256_srli_epi64(me, 32), _mm256_andnot_si256(lo32, mo));
+        __m256i low = _mm256_or_si256(_mm256_and_si256(me, lo32), _mm256_slli_epi64(mo, 32));
+        __m256i rej = _mm256_cmpgt_epi32(vt, _mm256_xor_si256(low, sign));
+        if (_mm256_testz_si256(rej, rej)) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + done), _mm256_add_epi32(hi, vlo));
+            done += 8;
+        } else {
+            alignas(32) u32 c[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(c), v);
+            done += rand_keep(c, span, t, lo, out + done, n - done);
+        }
+    }
+    for (int i = 0; i < 4; ++i) _mm256_store_si256(reinterpret_cast<__m256i*>(st.lanes[i]), s[i]);
+    return done;
+}
+
+X_TARGET_AVX2
+inline size_t rand_fill_avx2(RandState& st, f64* out, size_t n, f64 lo, f64 hi) noexcept {
+    __m256i s[4];
+    for (int i = 0; i < 4; ++i) s[i] = _mm256_load_si256(reinterpret_cast<const __m256i*>(st.lanes[i]));
+    const __m256i one   = _mm256_set1_epi64x(0x3ff0000000000000);
+    const __m256d vone  = _mm256_set1_pd(1.0);
+    const __m256d vlo   = _mm256_set1_pd(lo);
+    const __m256d width = _mm256_set1_pd(hi - lo);
+    const __m256d vhi   = _mm256_set1_pd(hi);
+    const __m256d below = _mm256_set1_pd(std::nextafter(hi, lo));
+    size_t done = 0;
+    for (; n - done >= 4; done += 4) {
+        __m256i v = rand_step_avx2(s);
+        __m256d u = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(v, 12), one)), vone);
+        __m256d r = _mm256_add_pd(vlo, _mm256_mul_pd(u, width));
+        // as rand_scale
+        _mm256_storeu_pd(out + done, _mm256_blendv_pd(r, below, _mm256_cmp_pd(r, vhi, _CMP_EQ_OQ)));
+    }
+    for (int i = 0; i < 4; ++i) _mm256_store_si256(reinterpret_cast<__m256i*>(st.lanes[i]), s[i]);
+    return done;
+}
+#endif
+} // namespace detail
+
+// the calling thread's engine
+inline Rng& rng() noexcept { return detail::rand_state().one; }
+
+// reseed the calling thread's engines, bulk fills included
+inline void seed_rand(u64 seed) noexcept { detail::rand_state().seed(seed); }
+
+inline i32 rand_int(i32 min, i32 max) noexcept {
+    if (max < min) std::swap(min, max);
+    u64 span = u64(u32(max) - u32(min)) + 1;
+    Rng& r   = rng();
+    return i32(u32(min) + (span >> 32 ? u32(r() >> 32) : r.below32(u32(span))));
+}
+
+// uniform in [min, max)
+inline f64 rand_float(f64 min = 0.0, f64 max = 1.0) noexcept {
+    return detail::rand_scale(rng().uniform(), min, max);
+}
+
+// fill with uniform ints in [min, max]. reproducible after seed_rand, and
+// the same values with or without avx2 (the scalar path mirrors its lanes)
+inline void rand_fill(std::span<i32> out, i32 min, i32 max) noexcept {
+    if (max < min) std::swap(min, max);
+    auto&  st   = detail::rand_state();
+    u64    span = u64(u32(max) - u32(min)) + 1;
+    u32    t    = u32(((u64(1) << 32) - span) % span);
+    size_t done = 0;
+#ifdef X_SIMD_X86
+    if (detail::has_avx2()) done = detail::rand_fill_avx2(st, out.data(), out.size(), min, span, t);
+#endif
+    u64 v[4];
+    u32 c[8];
+    while (done < out.size()) {
+        st.step(v);
+        detail::rand_halves(v, c);
+        done += detail::rand_keep(c, span, t, min, out.data() + done, out.size() - done);
+    }
+}
+
+// fill with uniform reals in [min, max), 52 random bits each
+inline void rand_fill(std::span<f64> out, f64 min = 0.0, f64 max = 1.0) noexcept {
+    auto&  st   = detail::rand_state();
+    size_t done = 0;
+#ifdef X_SIMD_X86
+    if (detail::has_avx2()) done = detail::rand_fill_avx2(st, out.data(), out.size(), min, max);
+#endif
+    u64 v[4];
+    while (done < out.size()) {
+        st.step(v);
+        for (size_t k = 0; k < 4 && done < out.size(); ++k)
+            out[done++] = detail::rand_scale(detail::rand_unit52(v[k]), min, max);
+    }
+}
+
+// ----------------------- Timer -----------------------
+
+class Timer {
+public:
+    Timer() = default;
+    ~Timer() { stop(); }
+
+    void start(cU64& interval_ms,
+               const std::function<void()>& task, 
+               const bool& repeat = false) {
+        stop();
+        running_ = true;
+        thread_ = std::thread([this, interval_ms, task, repeat]() {
+            while (running_) {
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (cv_.wait_for(lock, std::chrono::milliseconds(interval_ms),
+                                [this] { return !running_; })) {
+                    break;
+                }
+                if (running_) 
+                    task();
+                if (!repeat) 
+                    break;
+            }
+            running_ = false;
+        });
+    }
+
+    void stop() {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            running_ = false;
+            cv_.notify_all();
+        }
+        if (thread_.joinable()) 
+            thread_.join();
+    }
+
+    bool is_running() const noexcept { return running_;}
+
+private:
+    std::thread             thread_;
+    std::mutex              mutex_;
+    std::condition_variable cv_;
+    bool                    running_ = false;
+};
+
+// ----------------------- FileWatcher -----------------------
+// change notifications for files and directories (direct children), from
+// one background thread. inotify on linux, else (or with force_poll)
+// mtime / size snapshots diffed every poll_ms
+// events are coalesced per path and delivered in one batch once nothing
+// new arrived for debounce_ms
+//
+// x::FileWatcher w;
+// w.add("config.toml");  w.add("data/");
+// w.start([](const auto& evs) { for (auto& e : evs) reload(e.path); });
+enum class WatchEvent : u8 { Created, Modified, Removed };
+
+struct FileEvent {
+    str         path;
+    WatchEvent  kind;
+};
+
+struct WatchOptions {
+    u32  debounce_ms = 50;
+    u32  poll_ms     = 500;     // polling fallback only
+    bool force_poll  = false;
+};
+
+class FileWatcher {
+public:
+    using Callback = std::function<void(const _vec<FileEvent>&)>;
+
+    FileWatcher() = default;
+    ~FileWatcher() { stop(); }
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // a file, or a directory to report its direct children; false if missing
+    bool add(cStr& path) {
+        Stat st = stat(path);
+        if (!st.exists()) return false;
+        std::lock_guard lk(m_);
+        str p = path;
+        while (p.size() > 1 && (p.back() == '/' || p.back() == '\\')) p.pop_back();
+        bool dir   = st.is_dir();
+        bool fresh = dir ? dirs_.insert(p).second : files_.insert(p).second;
+        snapshot(p, dir, snap_);
+#ifdef __linux__
+        if (fd_ >= 0 && fresh) watch(p, dir);
+#endif
+        return true;
+    }
+
+    void remove(cStr& path) {
+        std::lock_guard lk(m_);
+        str p = path;
+        while (p.size() > 1 && (p.back() == '/' || p.back() == '\\')) p.pop_back();
+        bool file = files_.erase(p) > 0;
+        bool dir  = dirs_.erase(p) > 0;
+#ifdef __linux__
+        if (fd_ >= 0 && (file || dir)) unwatch(p, dir);
+#endif
+        std::erase_if(snap_, [&](const auto& kv) { return kv.first == p || parent(kv.first) == p; });
+    }
+
+    void start(Callback cb, const WatchOptions& opt = WatchOptions{}) {
+        stop();
+        cb_      = std::move(cb);
+        opt_     = opt;
+        running_ = true;
+#ifdef __linux__
+        if (!opt_.force_poll) {
+            fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (fd_ >= 0 && ::pipe(wake_) != 0) {
+                ::close(fd_);
+                fd_ = -1;
+            }
+            if (fd_ >= 0) {
+                std::lock_guard lk(m_);
+                for (auto& d : dirs_)  watch(d, true);
+                for (auto& f : files_) watch(f, false);
+            }
+        }
+        if (fd_ >= 0) {
+            thread_ = std::thread([this] { run_inotify(); });
+            return;
+        }
+#endif
+        thread_ = std::thread([this] { run_poll(); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard lk(m_);
+            running_ = false;
+            cv_.notify_all();
+        }
+#ifdef __linux__
+        if (fd_ >= 0) {
+            char c = 0;
+            [[maybe_unused]] auto r = ::write(wake_[1], &c, 1);
+        }
+#endif
+        if (thread_.joinable()) thread_.join();
+#ifdef __linux__
+        if (fd_ >= 0) {
+            ::close(fd_);
+            ::close(wake_[0]);
+            ::close(wake_[1]);
+            fd_ = -1;
+        }
+        wds_.clear();
+#endif
+        pending_.clear();
+    }
+
+    bool is_running() const noexcept { return running_; }
+    // true when the polling fallback is in use
+    bool polling() const noexcept {
+#ifdef __linux__
+        return running_ && fd_ < 0;
+#else
+        return running_;
+#endif
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static sView parent(cSView& p) noexcept {
+        size_t k = p.find_last_of("/\\");
+        return k == sView::npos ? sView{} : p.substr(0, std::max<size_t>(k, 1));
+    }
+
+    // merge a new event into what is pending for the path
+    void note(cStr& path, WatchEvent kind) {
+        auto [it, fresh] = pending_.try_emplace(path, kind);
+        if (!fresh) {
+            WatchEvent prev = it->second;
+            if (prev == WatchEvent::Created && kind == WatchEvent::Removed)      pending_.erase(it);
+            else if (prev == WatchEvent::Created)                               ;   // still new
+            else if (prev == WatchEvent::Removed && kind == WatchEvent::Created) it->second = WatchEvent::Modified;
+            else                                                                it->second = kind;
+        }
+        last_ = Clock::now();
+    }
+
+    // deliver once quiet for debounce_ms (or after 20x that, under a steady stream)
+    void deliver_if_quiet() {
+        if (pending_.empty()) {
+            first_ = {};
+            return;
+        }
+        auto now = Clock::now();
+        if (first_ == Clock::time_point{}) first_ = now;
+        auto d = std::chrono::milliseconds(opt_.debounce_ms);
+        if (now - last_ < d && now - first_ < d * 20) return;
+        _vec<FileEvent> out;
+        out.reserve(pending_.size());
+        for (auto& [p, k] : pending_) out.push_back({p, k});
+        pending_.clear();
+        first_ = {};
+        if (cb_) cb_(out);
+    }
+
+    // time left before pending events are due, -1 : nothing pending
+    i32 wait_ms() const {
+        if (pending_.empty()) return -1;
+        auto left = std::chrono::milliseconds(opt_.debounce_ms) - (Clock::now() - last_);
+        return i32(std::max<i64>(1, std::chrono::duration_cast<std::chrono::milliseconds>(left).count()));
+    }
+
+    // ---- polling ----
+    void snapshot(cStr& p, bool dir, _unmap<str, Stat>& into) {
+        if (!dir) {
+            Stat st = stat(p);
+            if (st.exists()) into[p] = st;
+            return;
+        }
+        WalkOptions o;
+        o.max_depth = 1;
+        o.threads   = 1;
+        for (auto& e : walk(p, o))
+            into[e.path] = Stat{e.type, e.size, e.mtime, 0};
+    }
+
+    void run_poll() {
+        std::unique_lock lk(m_);
+        while (running_) {
+            i32  due  = wait_ms();
+            auto tick = std::chrono::milliseconds(due < 0 ? opt_.poll_ms : std::min<u32>(u32(due), opt_.poll_ms));
+            if (cv_.wait_for(lk, tick, [this] { return !running_; })) break;
+            _unmap<str, Stat> now;
+            for (auto& d : dirs_)  snapshot(d, true, now);
+            for (auto& f : files_) snapshot(f, false, now);
+            for (auto& [p, st] : now) {
+                auto it = snap_.find(p);
+                if (it == snap_.end())
+                    note(p, WatchEvent::Created);
+                else if (it->second.mtime != st.mtime || it->second.size != st.size || it->second.type != st.type)
+                    note(p, WatchEvent::Modified);
+            }
+            for (auto& [p, st] : snap_)
+                if (!now.contains(p)) note(p, WatchEvent::Removed);
+            snap_ = std::move(now);
+            lk.unlock();
+            deliver_if_quiet();     // callback runs without the lock held
+            lk.lock();
+        }
+    }
+
+#ifdef __linux__
+    // ---- inotify : files are watched through their directory, so
+    //      editors that replace a file by rename keep being seen ----
+    static constexpr u32 kMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB |
+                                 IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+
+    void watch(cStr& p, bool dir) {
+        size_t k = p.find_last_of('/');
+        str    d = dir ? p : k == str::npos ? str(".") : str(parent(p));
+        int   wd = ::inotify_add_watch(fd_, d.c_str(), kMask);
+        if (wd < 0) return;
+        auto& w = wds_[wd];
+        w.dir = d;
+        if (dir) w.whole = true;
+        else     w.names[p.substr(k == str::npos ? 0 : k + 1)] = p;
+    }
+
+    // a directory watch is shared by the directory and the files in it,
+    // dropped once none of them is watched (inotify watches are per-user limited)
+    void unwatch(cStr& p, bool dir) {
+        size_t k = p.find_last_of('/');
+        str    d = dir ? p : k == str::npos ? str(".") : str(parent(p));
+        for (auto it = wds_.begin(); it != wds_.end(); ++it) {
+            auto& w = it->second;
+            if (w.dir != d) continue;
+            if (dir) w.whole = false;
+            else     w.names.erase(p.substr(k == str::npos ? 0 : k + 1));
+            if (!w.whole && w.names.empty()) {
+                ::inotify_rm_watch(fd_, it->first);
+                wds_.erase(it);
+            }
+            return;
+        }
+    }
+
+    void run_inotify() {
+        alignas(::inotify_event) char buf[64 * 1024];
+        for (;;) {
+            i32 due = wait_ms();
+            ::pollfd fds[2] = {{fd_, POLLIN, 0}, {wake_[0], POLLIN, 0}};
+            int r = ::poll(fds, 2, due);
+            if (!running_) break;
+            if (r < 0 && errno != EINTR) break;
+            if (r > 0 && (fds[0].revents & POLLIN)) {
+                std::lock_guard lk(m_);
+                ssize_t n;
+                while ((n = ::read(fd_, buf, sizeof(buf))) > 0) {
+                    for (char* q = buf; q < buf + n;) {
+                        auto* ev = reinterpret_cast<::inotify_event*>(q);
+                        handle(*ev);
+                        q += sizeof(::inotify_event) + ev->len;
+                    }
+                }
+            }
+            deliver_if_quiet();
+        }
+    }
+
+    void handle(const ::inotify_event& ev) {
+        if (ev.mask & IN_Q_OVERFLOW) {
+            // events were lost : report everything watched as changed
+            for (auto& f : files_) note(f, WatchEvent::Modified);
+            for (auto& d : dirs_)  note(d, WatchEvent::Modified);
+            return;
+        }
+        auto it = wds_.find(ev.wd);
+        if (it == wds_.end()) return;
+        const auto& w = it->second;
+        if (ev.mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+            if (w.whole && dirs_.contains(w.dir)) note(w.dir, WatchEvent::Removed);
+            if (ev.mask & IN_IGNORED) wds_.erase(it);
+            return;
+        }
+        if (ev.len == 0) return;
+        str path;
+        if (auto f = w.names.find(ev.name); f != w.names.end() && files_.contains(f->second))
+            path = f->second;
+        else if (w.whole && dirs_.contains(w.dir))
+            path = w.dir.ends_with('/') ? w.dir + ev.name : w.dir + "/" + ev.name;
+        else
+            return;     // not watched (any more)
+        WatchEvent kind = ev.mask & (IN_CREATE | IN_MOVED_TO)   ? WatchEvent::Created
+                        : ev.mask & (IN_DELETE | IN_MOVED_FROM) ? WatchEvent::Removed
+                        :                                          WatchEvent::Modified;
+        note(path, kind);
+    }
+
+    struct Watch {
+        str                 dir;
+        bool                whole = false;      // the directory itself is watched
+        std::map<str, str>  names;              // name -> watched file path
+    };
+
+    int                         fd_      = -1;
+    int                         wake_[2] = {-1, -1};
+    std::map<int, Watch>        wds_;
+#endif
+
+    Callback                    cb_;
+    WatchOptions                opt_;
+    std::atomic<bool>           running_{false};
+    std::thread                 thread_;
+    std::mutex                  m_;
+    std::condition_variable     cv_;
+    std::set<str>               files_;
+    std::set<str>               dirs_;
+    _unmap<str, Stat>           snap_;          // polling baseline
+    std::map<str, WatchEvent>   pending_;
+    Clock::time_point           last_{};
+    Clock::time_point           first_{};
+};
+
+// ----------------------- AppendLog -----------------------
+// append-only record log with group commit : any thread append()s, one
+// writer thread takes everything queued, writes it with writev and syncs
+// once for the whole batch
+// segments are base.00000001, base.00000002, ... ; the next one starts past
+// segment_size, and every open() starts a fresh one after the last on disk
+// frame : u32 size, u32 crc32c(payload), payload (little endian)
+//
+// x::AppendLog log("data/events", {.sync_ms = 10});
+// u64 seq = log.append(rec);
+// log.wait(seq);                                       // durable from here
+// x::AppendLog::replay("data/events", [](sView rec) { apply(rec); });
+struct AppendLogOptions {
+    u64  segment_size = 64 << 20;   // roll to the next segment past this size
+    u64  max_pending  = 64 << 20;   // append() blocks while more is queued
+    bool sync         = true;       // fdatasync written batches
+    u32  sync_ms      = 0;          // 0 : sync every batch, else at most this often
+};
+
+class AppendLog {
+public:
+    AppendLog() = default;
+    explicit AppendLog(cStr& base, const AppendLogOptions& opt = AppendLogOptions{}) { open(base, opt); }
+    ~AppendLog() { close(); }
 
-inline str read_file(cStr& path) {
-    std::ifstream file(path);
-    if (!file.is_open()) 
-        return "";
-    return str((std::istreambuf_iterator<char>(file)), 
-                std::istreambuf_iterator<char>());
-}
+    AppendLog(const AppendLog&) = delete;
+    AppendLog& operator=(const AppendLog&) = delete;
 
-inline void write_file(cStr& path, cStr& content) {
-    std::ofstream file(path);
-    if (!file.is_open()) {
-        throw std::runtime_error(_fmt("Failed to open file: {}", path));
+    void open(cStr& base, const AppendLogOptions& opt = AppendLogOptions{}) {
+        close();
+        base_ = base;
+        opt_  = opt;
+        auto segs = segments(base);
+        seg_no_   = segs.empty() ? 1 : segs.back().first + 1;
+        open_segment();
+        appended_ = written_ = durable_ = 0;
+        pending_bytes_ = 0;
+        error_.clear();
+        running_ = true;
+        stopped_ = false;
+        writer_  = std::thread([this] { run(); });
     }
-    file << content;
-}
 
-inline str join_path(const _vec<str>& parts) {
-    std::filesystem::path result;
-    for (const auto& part : parts) {
-        result /= part;
+    // write out and sync everything queued, then stop the writer
+    void close() {
+        {
+            std::lock_guard lk(m_);
+            if (!running_) return;
+            running_ = false;
+        }
+        work_cv_.notify_one();
+        writer_.join();
+        close_segment();
     }
-    return result.string();
-}
 
-inline _vec<str> split_path(cStr& path) {
-    _vec<str> result;
-    for (const auto& part : std::filesystem::path(path)) {
-        result.push_back(part.string());
+    // queue a record; returns its sequence number (1, 2, ... per open)
+    u64 append(str rec) {
+        if (rec.size() > UINT32_MAX)
+            throw std::runtime_error(_fmt("AppendLog: record too large ({} bytes): {}", rec.size(), base_));
+        std::unique_lock lk(m_);
+        space_cv_.wait(lk, [&] { return pending_bytes_ < opt_.max_pending || !running_ || !error_.empty(); });
+        check();
+        pending_bytes_ += rec.size() + 8;
+        queue_.push_back(std::move(rec));
+        u64 seq = ++appended_;
+        if (queue_.size() == 1) work_cv_.notify_one();
+        return seq;
     }
-    return result;
-}
 
-inline str norm_path(cStr& path) {
-    return std::filesystem::path(path).lexically_normal().string();
-}
+    // block until record seq is written (and synced when sync is on); with
+    // sync_ms that is the next periodic sync, so concurrent callers share it
+    void wait(u64 seq) { wait_for(seq, false); }
 
-inline u64 file_size(cStr& path) noexcept {
-    if (!std::filesystem::exists(path)) return 0;
-    return std::filesystem::file_size(path);
-}
+    // everything appended so far, synced right away
+    void flush() { wait_for(appended(), true); }
 
-inline _vec<str> list_dir(cStr& path) {
-    if (!std::filesystem::exists(path)) return {};
-    _vec<str> result;
-    for (const auto& entry : std::filesystem::directory_iterator(path)) {
-        result.push_back(entry.path().string());
+    u64 append_sync(str rec) {
+        u64 seq = append(std::move(rec));
+        wait(seq);
+        return seq;
     }
-    return result;
-}
-
-inline void create_dir(cStr& path) {
-    std::filesystem::create_directory(path);
-}
-
-inline void remove_file(cStr& path) {
-    std::filesystem::remove(path);
-}
-
-inline void remove_dir(cStr& path) {
-    std::filesystem::remove_all(path);
-}
 
-inline str file_time(cStr& path) {
-    if (!exists(path)) return "";
-    auto ftime = std::filesystem::last_write_time(path);
-    auto sys_time = std::chrono::clock_cast<std::chrono::system_clock>(ftime);
-    auto timestamp = std::chrono::system_clock::to_time_t(sys_time);
-    std::tm* tm = std::localtime(&timestamp);
-    std::ostringstream oss;
-    oss << std::put_time(tm, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
-}
+    u64  appended() const { std::lock_guard lk(m_); return appended_; }
+    u64  durable()  const { std::lock_guard lk(m_); return durable_;  }
+    bool is_open()  const { std::lock_guard lk(m_); return running_;  }
+    cStr& base()    const noexcept { return base_; }
 
-// ----------------------- utility functions -----------------------
+    // existing segments of base, (number, path) in order
+    static _vec<std::pair<u64, str>> segments(cStr& base) {
+        auto p    = std::filesystem::path(base);
+        auto dir  = p.parent_path().empty() ? std::filesystem::path(".") : p.parent_path();
+        str  stem = p.filename().string() + ".";
+        _vec<std::pair<u64, str>> out;
+        std::error_code ec;
+        for (auto& e : std::filesystem::directory_iterator(dir, ec)) {
+            str name = e.path().filename().string();
+            if (name.size() <= stem.size() || !name.starts_with(stem)) continue;
+            if (auto n = parse<u64>(sView(name).substr(stem.size())))
+                out.emplace_back(*n, e.path().string());
+        }
+        std::sort(out.begin(), out.end());
+        return out;
+    }
 
-inline u64 id_thread() noexcept{
-    std::hash<std::thread::id> hasher;
-    return hasher(std::this_thread::get_id());
-}
+    // feed every intact record of every segment to fn(sView), in append
+    // order; fn may return false to stop. a torn or corrupt frame ends its
+    // segment (a crash mid-batch), replay goes on with the next one.
+    // returns the number of records replayed
+    template<typename F>
+    static u64 replay(cStr& base, F&& fn) {
+        u64 n = 0;
+        for (auto& [no, path] : segments(base)) {
+            MappedFile m(path, {.advice = MapAdvice::Sequential});
+            sView      d = m.view();
+            for (size_t off = 0; d.size() - off >= 8;) {
+                auto   h   = reinterpret_cast<const u8*>(d.data() + off);
+                size_t len = detail::xxh::rd32(h);
+                if (d.size() - off - 8 < len) break;
+                sView rec = d.substr(off + 8, len);
+                if (crc32c(rec) != detail::xxh::rd32(h + 4)) break;
+                off += 8 + len;
+                ++n;
+                if constexpr (std::is_void_v<std::invoke_result_t<F&, sView>>) fn(rec);
+                else if (!fn(rec)) return n;
+            }
+        }
+        return n;
+    }
 
-inline void sleep(cU64& milliseconds) noexcept {
-    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
-}
+private:
+    using Clock = std::chrono::steady_clock;
 
-inline str current_time(cStr& format = "%Y-%m-%d %H:%M:%S") noexcept {
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    std::tm tm = *std::localtime(&time);
-    std::stringstream ss;
-    ss << std::put_time(&tm, format.c_str());
-    return ss.str();
-}
+    void check() const {
+        if (!error_.empty()) throw std::runtime_error(error_);
+        if (!running_) throw std::runtime_error(_fmt("AppendLog is closed: {}", base_));
+    }
 
-inline u64 timestamp() noexcept {
-    return std::chrono::steady_clock::now().
-            time_since_epoch().count();
-}
+    void wait_for(u64 seq, bool now) {
+        std::unique_lock lk(m_);
+        if (seq > durable_ && now) {
+            urgent_ = true;
+            work_cv_.notify_one();
+        }
+        // close() still drains and syncs the queue : wait for the writer to
+        // exit, not for running_ to drop
+        done_cv_.wait(lk, [&] { return durable_ >= seq || !error_.empty() || stopped_; });
+        if (durable_ < seq) check();
+    }
 
-inline u64 timestamp_ms() noexcept {
-    return std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::steady_clock::now().time_since_epoch()).count();
-}
+    str segment_path() const { return _fmt("{}.{:08}", base_, seg_no_); }
 
-inline u64 timestamp_us() noexcept {
-    return std::chrono::duration_cast<std::chrono::microseconds>(
-            std::chrono::steady_clock::now().time_since_epoch()).count();
-}
+    void open_segment() {
+        str path = segment_path();
+#ifdef _WIN32
+        file_.open(path, std::ios::binary | std::ios::app);
+        if (!file_.is_open())
+#else
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_APPEND | O_CLOEXEC, 0666);
+        if (fd_ < 0)
+#endif
+            throw std::runtime_error(_fmt("Failed to open file: {}", path));
+#ifndef _WIN32
+        if (opt_.sync) detail::sync_dir(path);
+#endif
+        seg_size_ = 0;
+    }
 
-inline i32 rand_int(i32 min, i32 max) noexcept {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_int_distribution<i32> dist(min, max);
-    return dist(gen);
-}
+    void close_segment() {
+#ifdef _WIN32
+        file_.close();
+#else
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+#endif
+    }
 
-inline f64 rand_float(f64 min = 0.0, f64 max = 1.0) noexcept {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_real_distribution<f64> dist(min, max);
-    return dist(gen);
-}
+    void write_parts(std::span<const sView> parts) {
+#ifdef _WIN32
+        for (auto& p : parts) file_.write(p.data(), std::streamsize(p.size()));
+        if (!file_) throw std::runtime_error(_fmt("Failed to write file: {}", segment_path()));
+#else
+        detail::write_all(fd_, parts, segment_path());
+#endif
+    }
 
-template<typename T>
-inline T clamp(T value, T min, T max) noexcept {
-    return (value < min) ? min : (value > max) ? max : value;
-}
+    void sync_segment() {
+#ifdef _WIN32
+        file_.flush();
+#elif defined(__APPLE__)
+        if (::fsync(fd_) != 0)
+            throw std::runtime_error(_fmt("Failed to sync file: {} ({})", segment_path(), std::strerror(errno)));
+#else
+        if (::fdatasync(fd_) != 0)
+            throw std::runtime_error(_fmt("Failed to sync file: {} ({})", segment_path(), std::strerror(errno)));
+#endif
+    }
 
-// ----------------------- Timer -----------------------
+    // frames for batch, one writev per segment touched
+    void write_batch(_vec<str>& batch) {
+        hdrs_.resize(batch.size());
+        parts_.clear();
+        for (size_t i = 0; i < batch.size(); ++i) {
+            u64 frame = batch[i].size() + 8;
+            if (seg_size_ > 0 && seg_size_ + frame > opt_.segment_size) {
+                write_parts(parts_);
+                parts_.clear();
+                if (opt_.sync) sync_segment();
+                close_segment();
+                ++seg_no_;
+                open_segment();
+            }
+            u64 hdr = u64(batch[i].size()) | (u64(crc32c(batch[i])) << 32);
+            detail::xxh::wr64(reinterpret_cast<u8*>(hdrs_[i].data()), hdr);
+            parts_.emplace_back(hdrs_[i].data(), 8);
+            parts_.emplace_back(batch[i]);
+            seg_size_ += frame;
+        }
+        write_parts(parts_);
+    }
 
-class Timer {
-public:
-    Timer() = default;
-    ~Timer() { stop(); }
+    void run() {
+        _vec<str>         batch;
+        Clock::time_point last_sync = Clock::now();
+        bool              unsynced  = false;
+        std::unique_lock  lk(m_);
+        for (;;) {
+            auto due = last_sync + std::chrono::milliseconds(opt_.sync_ms);
+            auto ready = [&] { return !queue_.empty() || !running_ || (unsynced && urgent_); };
+            if (unsynced) work_cv_.wait_until(lk, due, ready);
+            else          work_cv_.wait(lk, ready);
+            batch.swap(queue_);
+            u64  last     = appended_;
+            bool stopping = !running_;
+            pending_bytes_ = 0;
+            space_cv_.notify_all();
+            lk.unlock();
 
-    void start(cU64& interval_ms,
-               const std::function<void()>& task, 
-               const bool& repeat = false) {
-        stop();
-        running_ = true;
-        thread_ = std::thread([this, interval_ms, task, repeat]() {
-            while (running_) {
-                std::unique_lock<std::mutex> lock(mutex_);
-                if (cv_.wait_for(lock, std::chrono::milliseconds(interval_ms),
-                                [this] { return !running_; })) {
-                    break;
+            bool synced = false;
+            try {
+                if (!batch.empty()) {
+                    write_batch(batch);
+                    unsynced = opt_.sync;
                 }
-                if (running_) 
-                    task();
-                if (!repeat) 
-                    break;
+                // group commit : one sync covers every record written since the last
+                if (unsynced && (opt_.sync_ms == 0 || stopping || urgent_flag() || Clock::now() >= due)) {
+                    sync_segment();
+                    last_sync = Clock::now();
+                    unsynced  = false;
+                    synced    = true;
+                }
+            } catch (const std::exception& e) {
+                lk.lock();
+                error_ = e.what();
+                done_cv_.notify_all();
+                space_cv_.notify_all();
+                return;
             }
-            running_ = false;
-        });
-    }
+            batch.clear();
 
-    void stop() {
-        {
-            std::unique_lock<std::mutex> lock(mutex_);
-            running_ = false;
-            cv_.notify_all();
+            lk.lock();
+            written_ = last;
+            if (!opt_.sync || synced) {
+                durable_ = written_;
+                urgent_  = false;
+            }
+            stopped_ = stopping && queue_.empty();
+            done_cv_.notify_all();
+            if (stopped_) return;
         }
-        if (thread_.joinable()) 
-            thread_.join();
     }
 
-    bool is_running() const noexcept { return running_;}
+    bool urgent_flag() {
+        std::lock_guard lk(m_);
+        return urgent_;
+    }
 
-private:
-    std::thread             thread_;
-    std::mutex              mutex_;
-    std::condition_variable cv_;
-    bool                    running_ = false;
+    str                         base_;
+    AppendLogOptions            opt_;
+    u64                         seg_no_   = 0;
+    u64                         seg_size_ = 0;
+#ifdef _WIN32
+    std::ofstream               file_;
+#else
+    int                         fd_       = -1;
+#endif
+
+    mutable std::mutex          m_;
+    std::condition_variable     work_cv_;   // writer : records queued / urgent / stop
+    std::condition_variable     done_cv_;   // waiters : durable_ moved
+    std::condition_variable     space_cv_;  // append : queue drained
+    _vec<str>                   queue_;
+    u64                         pending_bytes_ = 0;
+    u64                         appended_      = 0;
+    u64                         written_       = 0;
+    u64                         durable_       = 0;
+    bool                        urgent_        = false;    // flush() : sync now
+    bool                        running_       = false;
+    bool                        stopped_       = true;     // writer has exited
+    str                         error_;
+    std::thread                 writer_;
+
+    // writer thread only
+    _vec<std::array<char, 8>>   hdrs_;
+    _vec<sView>                 parts_;
 };
 
 // ----------------------- Result -----------------------
@@ -862,4 +5648,434 @@ private:
     u64 tp_us_;
 };
 
+// ----------------------- Log -----------------------
+// asynchronous logger : the calling thread only copies the format string
+// pointer and the argument values into its own lock-free ring, a writer
+// thread formats and writes batches to the console / a rotating file
+//
+// x::Log::instance().start({.level = x::LogLevel::Debug, .file = "app.log"});
+// _log_info("user {} logged in from {}", name, ip);
+enum class LogLevel : u8 { Trace, Debug, Info, Warn, Error, Fatal, Off };
+
+// what a thread does when its ring is full
+//   Block : wait for the writer
+//   Drop  : discard the record
+//   Count : discard it and have the writer report how many were lost
+enum class LogOverflow : u8 { Block, Drop, Count };
+
+struct LogConfig {
+    LogLevel    level         = LogLevel::Info;
+    LogOverflow overflow      = LogOverflow::Block;
+    size_t      ring_size     = 1024;       // records per thread, rounded up to 2^n
+    bool        console       = true;
+    str         file;                       // empty : no file
+    u64         max_file_size = 64 << 20;   // rotate past this size
+    u32         max_files     = 5;          // app.log.1 .. app.log.N
+    u64         flush_ms      = 50;         // writer wakes at least this often
+    std::function<void(sView)> sink;        // extra sink, receives whole batches
+};
+
+namespace detail {
+
+// fixed-size slot, arguments are constructed in place in args
+struct alignas(64) LogRecord {
+    using Fn = void (*)(LogRecord& r, str* out);   // out == null : destroy only
+
+    static constexpr size_t kArgBytes = 192;
+
+    Fn          fn;
+    sView       fmt;
+    sView       file;                       // basename, static storage
+    u64         ts_ns;
+    u32         line;
+    LogLevel    level;
+    alignas(16) std::byte args[kArgBytes];
+};
+
+// single producer (owning thread) / single consumer (writer)
+struct LogRing {
+    explicit LogRing(size_t cap) : slots(std::bit_ceil(std::max<size_t>(cap, 2))), mask(slots.size() - 1) {}
+
+    _vec<LogRecord>                 slots;
+    const u64                       mask;
+    alignas(64) std::atomic<u64>    head{0};
+    alignas(64) std::atomic<u64>    tail{0};
+    std::atomic<bool>               dead{false};
+};
+
+// strings are copied, everything else is stored decayed
+template<typename T>
+using log_arg_t = std::conditional_t<std::is_convertible_v<const std::decay_t<T>&, sView>,
+                                     str, std::decay_t<T>>;
+
+template<typename Tuple>
+inline void log_format(LogRecord& r, str* out) {
+    auto* t = std::launder(reinterpret_cast<Tuple*>(r.args));
+    if (out) {
+        try {
+            std::apply([&](auto&... a) {
+                std::vformat_to(std::back_inserter(*out), r.fmt, std::make_format_args(a...));
+            }, *t);
+        } catch (...) {
+            *out += "<format error>";
+        }
+    }
+    t->~Tuple();
+}
+
+inline void log_format_str(LogRecord& r, str* out) {
+    log_format<std::tuple<str>>(r, out);
+}
+
+class RotatingFile {
+public:
+    void open(cStr& path, u64 max_size, u32 max_files) {
+        path_ = path; max_size_ = max_size; max_files_ = max_files;
+        f_.open(path_, std::ios::binary | std::ios::app);
+        std::error_code ec;
+        size_ = std::filesystem::exists(path_, ec) ? std::filesystem::file_size(path_, ec) : 0;
+    }
+
+    void write(cSView& s) {
+        if (!f_.is_open()) return;
+        if (size_ > 0 && size_ + s.size() > max_size_) rotate();
+        f_.write(s.data(), std::streamsize(s.size()));
+        size_ += s.size();
+    }
+
+    void flush() { if (f_.is_open()) f_.flush(); }
+    void close() { f_.close(); }
+
+private:
+    // app.log -> app.log.1 -> ... -> app.log.N (dropped)
+    void rotate() {
+        f_.close();
+        std::error_code ec;
+        for (u32 i = max_files_; i > 1; --i)
+            std::filesystem::rename(_fmt("{}.{}", path_, i - 1), _fmt("{}.{}", path_, i), ec);
+        if (max_files_ > 0) std::filesystem::rename(path_, path_ + ".1", ec);
+        else std::filesystem::remove(path_, ec);
+        f_.open(path_, std::ios::binary | std::ios::trunc);
+        size_ = 0;
+    }
+
+    str           path_;
+    u64           max_size_  = 0;
+    u32           max_files_ = 0;
+    std::ofstream f_;
+    u64           size_      = 0;
+};
+
+} // namespace detail
+
+class Log {
+public:
+    static Log& instance() {
+        static Log log;
+        return log;
+    }
+
+    ~Log() { stop(); }
+
+    // (re)start the writer with cfg, pending records are written first
+    void start(const LogConfig& cfg = {}) {
+        std::lock_guard<std::mutex> lock(ctl_m_);
+        stop_locked();
+        cfg_ = cfg;
+        level_.store(u8(cfg.level), std::memory_order_relaxed);
+        overflow_.store(u8(cfg.overflow), std::memory_order_relaxed);
+        ring_size_.store(cfg.ring_size, std::memory_order_relaxed);
+        if (!cfg_.file.empty())
+            file_.open(cfg_.file, cfg_.max_file_size, cfg_.max_files);
+        running_.store(true);
+        writer_ = std::thread([this] { run(); });
+    }
+
+    // drain everything and join the writer
+    void stop() {
+        std::lock_guard<std::mutex> lock(ctl_m_);
+        stop_locked();
+    }
+
+    // block until everything logged before this call is written
+    void flush() {
+        if (!running_.load()) return;
+        std::unique_lock<std::mutex> lock(wait_m_);
+        u64 req = ++flush_req_;
+        wake_cv_.notify_one();
+        flush_cv_.wait(lock, [&] { return flush_done_ >= req || !running_.load(); });
+    }
+
+    bool enabled(LogLevel lv) const noexcept {
+        return u8(lv) >= level_.load(std::memory_order_relaxed) && lv != LogLevel::Off;
+    }
+
+    void     set_level(LogLevel lv) noexcept { level_.store(u8(lv), std::memory_order_relaxed); }
+    LogLevel level()   const noexcept { return LogLevel(level_.load(std::memory_order_relaxed)); }
+    u64      dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+    template<typename... Args>
+    void write(LogLevel lv, sView file, u32 line, std::format_string<Args...> ft, Args&&... args) {
+        if (!enabled(lv)) return;
+        using Tuple = std::tuple<detail::log_arg_t<Args>...>;
+        auto  ts = std::chrono::system_clock::now().time_since_epoch();
+        auto& rg = ring();
+        auto* r  = acquire(rg);
+        if (!r) return;
+        r->fmt   = detail::fmt_view(ft);
+        r->file  = file;
+        r->line  = line;
+        r->level = lv;
+        r->ts_ns = u64(std::chrono::duration_cast<std::chrono::nanoseconds>(ts).count());
+        if constexpr (sizeof(Tuple) <= detail::LogRecord::kArgBytes && alignof(Tuple) <= 16) {
+            new (r->args) Tuple(std::forward<Args>(args)...);
+            r->fn = &detail::log_format<Tuple>;
+        } else {
+            // too big for the slot : format here
+            new (r->args) std::tuple<str>(std::format(ft, std::forward<Args>(args)...));
+            r->fmt = "{}";
+            r->fn  = &detail::log_format_str;
+        }
+        rg.head.store(rg.head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // flush pending records on SIGSEGV / SIGABRT / ... and std::terminate,
+    // then hand over to the handlers installed before, or the default action
+    // (best effort, not async-signal-safe). installs once
+    void install_crash_handler() {
+        static std::terminate_handler prev = std::set_terminate([] {
+            Log::instance().crash_flush();
+            if (prev) prev();
+            std::abort();
+        });
+        static std::once_flag once;
+        std::call_once(once, [] {
+            for (auto& [sig, old] : crash_signals()) {
+                auto h = std::signal(sig, [](int s) {
+                    Log::instance().crash_flush();
+                    for (auto& [hooked, prev_h] : crash_signals()) {
+                        if (hooked != s) continue;
+                        std::signal(s, prev_h);
+                        if (prev_h != SIG_DFL && prev_h != SIG_IGN) {
+                            prev_h(s);
+                            return;
+                        }
+                    }
+                    std::signal(s, SIG_DFL);
+                    std::raise(s);
+                });
+                old = h == SIG_ERR ? SIG_DFL : h;
+            }
+        });
+    }
+
+    // drain from the calling thread, used by the crash hooks; gives up rather
+    // than wait on a lock the crashed thread may hold
+    void crash_flush() noexcept {
+        std::unique_lock<std::mutex> lock(consume_m_, std::defer_lock);
+        if (!crash_lock(lock)) return;
+        try {
+            str batch;
+            drain(batch, true);
+            emit(batch);
+            file_.flush();
+        } catch (...) {}
+    }
+
+private:
+    Log() { start(); }
+
+    using SigHandler = void (*)(int);
+
+    // signals hooked by install_crash_handler, with the handler each replaced
+    static std::span<std::pair<int, SigHandler>> crash_signals() {
+        static std::pair<int, SigHandler> sigs[] = {
+            {SIGSEGV, SIG_DFL}, {SIGABRT, SIG_DFL}, {SIGFPE, SIG_DFL}, {SIGILL, SIG_DFL},
+#ifdef SIGBUS
+            {SIGBUS, SIG_DFL},
+#endif
+        };
+        return sigs;
+    }
+
+    static bool crash_lock(std::unique_lock<std::mutex>& lock) noexcept {
+        for (int i = 0; i < 100000 && !lock.try_lock(); ++i)
+            std::this_thread::yield();
+        return lock.owns_lock();
+    }
+
+    struct RingHandle {
+        std::shared_ptr<detail::LogRing> ring;
+        ~RingHandle() { if (ring) ring->dead.store(true, std::memory_order_release); }
+    };
+
+    detail::LogRing& ring() {
+        thread_local RingHandle h;
+        if (!h.ring) {
+            h.ring = std::make_shared<detail::LogRing>(ring_size_.load(std::memory_order_relaxed));
+            std::lock_guard<std::mutex> lock(rings_m_);
+            rings_.push_back(h.ring);
+        }
+        return *h.ring;
+    }
+
+    detail::LogRecord* acquire(detail::LogRing& rg) {
+        u64 h = rg.head.load(std::memory_order_relaxed);
+        while (h - rg.tail.load(std::memory_order_acquire) > rg.mask) {
+            auto policy = LogOverflow(overflow_.load(std::memory_order_relaxed));
+            if (policy != LogOverflow::Block || !running_.load(std::memory_order_relaxed)) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                if (policy == LogOverflow::Count)
+                    unreported_.fetch_add(1, std::memory_order_relaxed);
+                return _nul;
+            }
+            wake_.store(true, std::memory_order_release);
+            wake_cv_.notify_one();
+            std::this_thread::yield();
+        }
+        return &rg.slots[h & rg.mask];
+    }
+
+    void stop_locked() {
+        if (!writer_.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(wait_m_);
+            running_.store(false);
+            wake_cv_.notify_one();
+            flush_cv_.notify_all();
+        }
+        writer_.join();
+        file_.close();
+    }
+
+    void run() {
+        str batch;
+        batch.reserve(1 << 16);
+        for (;;) {
+            u64  req;
+            bool stopping;
+            {
+                std::lock_guard<std::mutex> lock(wait_m_);
+                req      = flush_req_;
+                stopping = !running_.load();
+            }
+            // cleared before draining : a ring that fills up again sets it anew
+            wake_.store(false, std::memory_order_relaxed);
+            {
+                std::lock_guard<std::mutex> lock(consume_m_);
+                drain(batch);
+                emit(batch);
+                if (req != flush_done_) file_.flush();
+            }
+            std::unique_lock<std::mutex> lock(wait_m_);
+            if (req != flush_done_) {
+                flush_done_ = req;
+                flush_cv_.notify_all();
+            }
+            if (stopping) break;
+            wake_cv_.wait_for(lock, std::chrono::milliseconds(cfg_.flush_ms),
+                              [&] { return flush_req_ != req || !running_.load() || wake_.load(std::memory_order_acquire); });
+        }
+    }
+
+    // format every pending record into batch, emitting every 64 KiB
+    void drain(str& batch, bool crash = false) {
+        {
+            std::unique_lock<std::mutex> lock(rings_m_, std::defer_lock);
+            if (!crash) lock.lock();
+            else if (!crash_lock(lock)) return;
+            snapshot_ = rings_;
+            std::erase_if(rings_, [](const auto& r) {
+                return r->dead.load(std::memory_order_acquire) &&
+                       r->head.load(std::memory_order_acquire) == r->tail.load(std::memory_order_relaxed);
+            });
+        }
+        for (auto& rg : snapshot_) {
+            u64 t = rg->tail.load(std::memory_order_relaxed);
+            u64 h = rg->head.load(std::memory_order_acquire);
+            for (; t != h; ++t) {
+                format_record(rg->slots[t & rg->mask], batch);
+                if ((t & 63) == 63) rg->tail.store(t + 1, std::memory_order_release);
+                if (batch.size() >= (1 << 16)) emit(batch);
+            }
+            rg->tail.store(t, std::memory_order_release);
+        }
+        snapshot_.clear();
+        if (u64 n = unreported_.exchange(0, std::memory_order_relaxed))
+            batch += _fmt("x::Log dropped {} messages\n", n);
+    }
+
+    // "2025-06-09 12:00:00.123456 INFO  main.cpp:42 message\n"
+    void format_record(detail::LogRecord& r, str& out) {
+        static constexpr const char* names[] = {"TRACE", "DEBUG", "INFO ", "WARN ", "ERROR", "FATAL"};
+        i64 sec = i64(r.ts_ns / 1000000000);
+        if (sec != last_sec_) {
+            std::time_t t = std::time_t(sec);
+            std::tm tm{};
+#ifdef _WIN32
+            localtime_s(&tm, &t);
+#else
+            localtime_r(&t, &tm);
+#endif
+            char buf[32];
+            sec_str_.assign(buf, std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm));
+            last_sec_ = sec;
+        }
+        std::format_to(std::back_inserter(out), "{}.{:06} {} {}:{} ",
+                       sec_str_, (r.ts_ns / 1000) % 1000000, names[u8(r.level) % 6], r.file, r.line);
+        r.fn(r, &out);
+        out += '\n';
+    }
+
+    void emit(str& batch) {
+        if (batch.empty()) return;
+        if (cfg_.console) detail::out_sink(false, batch, false);
+        file_.write(batch);
+        if (cfg_.sink) cfg_.sink(batch);
+        batch.clear();
+    }
+
+    LogConfig                                       cfg_;
+    std::atomic<u8>                                 level_{u8(LogLevel::Info)};
+    std::atomic<u8>                                 overflow_{u8(LogOverflow::Block)};
+    std::atomic<bool>                               running_{false};
+    std::atomic<bool>                               wake_{false};   // a ring is full, drain now
+    std::atomic<u64>                                dropped_{0};
+    std::atomic<u64>                                unreported_{0};
+    std::atomic<size_t>                             ring_size_{1024};
+
+    std::mutex                                      ctl_m_;     // start / stop
+    std::mutex                                      rings_m_;
+    std::mutex                                      consume_m_; // one consumer at a time
+    std::mutex                                      wait_m_;
+    std::condition_variable                         wake_cv_;
+    std::condition_variable                         flush_cv_;
+    u64                                             flush_req_  = 0;
+    u64                                             flush_done_ = 0;
+
+    _vec<std::shared_ptr<detail::LogRing>>          rings_;
+    _vec<std::shared_ptr<detail::LogRing>>          snapshot_;
+    std::thread                                     writer_;
+    detail::RotatingFile                            file_;
+    i64                                             last_sec_ = -1;
+    str                                             sec_str_;
+};
+
+#define _log(lv, ...)   do { if (x::Log::instance().enabled(lv)) \
+                            x::Log::instance().write(lv, _file_name(), __LINE__, __VA_ARGS__); } while (0)
+#define _log_trace(...) _log(x::LogLevel::Trace, __VA_ARGS__)
+#define _log_debug(...) _log(x::LogLevel::Debug, __VA_ARGS__)
+#define _log_info(...)  _log(x::LogLevel::Info,  __VA_ARGS__)
+#define _log_warn(...)  _log(x::LogLevel::Warn,  __VA_ARGS__)
+#define _log_error(...) _log(x::LogLevel::Error, __VA_ARGS__)
+#define _log_fatal(...) _log(x::LogLevel::Fatal, __VA_ARGS__)
+
 } // namespace x
+
+// print / format a StrBuf without copying : _prtln("{}", buf)
+template<size_t N>
+struct std::formatter<x::StrBuf<N>> : std::formatter<std::string_view> {
+    auto format(const x::StrBuf<N>& b, auto& ctx) const {
+        return std::formatter<std::string_view>::format(b.view(), ctx);
+    }
+};